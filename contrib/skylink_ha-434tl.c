@@ -87,7 +87,7 @@ static int skylink_motion_callback(r_device* decoder, bitbuffer_t* bitbuffer) {
       continue;
 
     {
-      if (decoder->verbose > 1)
+      if (decoder_verbose(decoder) > 1)
         fprintf(stderr, "%s: rows %d row %i bits %d\n", __func__, bitbuffer->num_rows, i, bitbuffer->bits_per_row[i]);
       // [01] {17} 5e 3e 80  : 01011110 00111110 1  -- No motion
       // [01] {17} be 3e 80  : 10111110 00111110 1  -- Motion
@@ -134,7 +134,7 @@ static char const* output_fields[] = {
     "raw",
     NULL};
 
-r_device skylink_motion = {
+r_device const skylink_motion = {
     .name = "Skylink HA-434TL motion sensor",
     .modulation = OOK_PULSE_PPM,
     .short_width = 600, // Divide by 4 from DEBUG ouput
@@ -107,6 +107,8 @@ uint8_t crc7(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uint8
 /// Example polynomial: 0x31 = x8 + x5 + x4 + 1 (x8 is implicit)
 /// Example polynomial: 0x80 = x8 + x7 (a normal bit-by-bit parity XOR)
 ///
+/// Table driven for the polynomials 0x31 and 0x07, bit-serial otherwise.
+///
 /// @param message array of bytes to check
 /// @param nBytes number of bytes in message
 /// @param polynomial byte is from x^7 to x^0 (x^8 is implicitly one)
@@ -116,6 +118,7 @@ uint8_t crc8(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uint8
 
 /// "Little-endian" Cyclic Redundancy Check CRC-8 LE
 /// Input and output are reflected, i.e. least significant bit is shifted in first.
+/// Table driven for the polynomials 0x31 and 0x07, bit-serial otherwise.
 ///
 /// @param message array of bytes to check
 /// @param nBytes number of bytes in message
@@ -127,6 +130,7 @@ uint8_t crc8le(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uin
 /// CRC-16 LSB.
 /// Input and output are reflected, i.e. least significant bit is shifted in first.
 /// Note that poly and init already need to be reflected.
+/// Table driven for the polynomials 0xa001 and 0x8408, bit-serial otherwise.
 ///
 /// @param message array of bytes to check
 /// @param nBytes number of bytes in message
@@ -137,6 +141,8 @@ uint16_t crc16lsb(uint8_t const message[], unsigned nBytes, uint16_t polynomial,
 
 /// CRC-16.
 ///
+/// Table driven for the polynomials 0x1021 and 0x8005, bit-serial otherwise.
+///
 /// @param message array of bytes to check
 /// @param nBytes number of bytes in message
 /// @param polynomial CRC polynomial
@@ -146,6 +152,8 @@ uint16_t crc16(uint8_t const message[], unsigned nBytes, uint16_t polynomial, ui
 
 /// Digest-8 by "LFSR-based Toeplitz hash", bits MSB to LSB.
 ///
+/// Table driven for the gen 0x98, bit-serial otherwise.
+///
 /// @param message bytes of message data
 /// @param bytes number of bytes to digest
 /// @param gen key stream generator, needs to includes the MSB for ROR if the LFSR is rolling
@@ -164,6 +172,8 @@ uint8_t lfsr_digest8_reverse(uint8_t const message[], int bytes, uint8_t gen, ui
 
 /// Digest-8 by "LFSR-based Toeplitz hash", byte reversed, bit reflect (LSB to MSB).
 ///
+/// Table driven for the gens 0x31 and 0x51, bit-serial otherwise.
+///
 /// @param message bytes of message data, read in reverse
 /// @param bytes number of bytes to digest
 /// @param gen key stream generator, needs to includes the LSB for ROL if the LFSR is rolling
@@ -173,6 +183,8 @@ uint8_t lfsr_digest8_reflect(uint8_t const message[], int bytes, uint8_t gen, ui
 
 /// Digest-16 by "LFSR-based Toeplitz hash".
 ///
+/// Table driven for the gen 0x8810, bit-serial otherwise.
+///
 /// @param message bytes of message data
 /// @param bytes number of bytes to digest
 /// @param gen key stream generator, needs to includes the MSB if the LFSR is rolling
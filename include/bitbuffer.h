@@ -29,21 +29,68 @@
 typedef uint8_t bitrow_t[BITBUF_COLS];
 typedef bitrow_t bitarray_t[BITBUF_ROWS];
 
+#define BITBUF_PREAMBLES 16 // Number of distinct search patterns cached per slice, max 16
+
+/// First matches of the patterns searched for in a slice, see bitbuffer_search().
+///
+/// Patterns of 8 to 32 bits are learned as they are searched for, the first
+/// search in a row then finds all learned patterns in one pass over the row.
+/// Matches are only used by a bitbuffer unchanged since the slice was shared.
+typedef struct bitbuffer_preambles {
+    uint32_t pattern[BITBUF_PREAMBLES];                  ///< Learned patterns, MSB aligned
+    uint8_t pattern_bits[BITBUF_PREAMBLES];              ///< Length of the learned patterns
+    unsigned num_patterns;                               ///< Number of learned patterns
+    uint16_t first_byte[256];                            ///< Mask of the patterns starting with each byte
+    uint8_t row_valid[BITBUF_ROWS];                      ///< Rows with matches for all learned patterns
+    uint16_t row_bits[BITBUF_ROWS];                      ///< Row length the matches were found in
+    uint16_t first_match[BITBUF_ROWS][BITBUF_PREAMBLES]; ///< First match per row and pattern, row length if none
+} bitbuffer_preambles_t;
+
 /// Bit buffer.
 typedef struct bitbuffer {
     uint16_t num_rows;                      ///< Number of active rows
     uint16_t free_row;                      ///< Index of next free row
+    uint16_t dirty_rows;                    ///< High-water mark of rows in use, for bitbuffer_clear()
+    uint16_t dirty_cols;                    ///< High-water mark of bytes written per row, for bitbuffer_clear()
+    bitbuffer_preambles_t *preambles;       ///< Search results shared by the copies of a slice, NULL once changed
     uint16_t bits_per_row[BITBUF_ROWS];     ///< Number of active bits per row
     uint16_t syncs_before_row[BITBUF_ROWS]; ///< Number of sync pulses before row
     bitarray_t bb;                          ///< The actual bits buffer
 } bitbuffer_t;
 
 /// Clear the content of the bitbuffer.
+///
+/// Only the rows and columns written since the last clear are zeroed, up to
+/// the widest row, the bitbuffer must have been zero initialized before its
+/// first use.
 void bitbuffer_clear(bitbuffer_t *bits);
 
+/// Mark every column of the rows in use as written.
+///
+/// Needed after code wrote to bb directly past bits_per_row, e.g. a decoder
+/// handed the bitbuffer, those bytes are not cleared otherwise.
+/// Also detaches shared preambles.
+void bitbuffer_touch(bitbuffer_t *bits);
+
+/// Copy the content of the bitbuffer, touching only the rows and columns in use.
+void bitbuffer_copy(bitbuffer_t *dst, bitbuffer_t const *src);
+
+/// Share the search results of the current slice with the copies made of it.
+///
+/// Results of a previous slice are dropped, learned patterns are kept.
+/// The slice itself may be searched too, a row is matched when first searched.
+/// A bitbuffer changed through the API is detached from the results, code
+/// writing to bb directly must call bitbuffer_touch() before searching again.
+void bitbuffer_share_preambles(bitbuffer_t *bits, bitbuffer_preambles_t *preambles);
+
 /// Add a single bit at the end of the bitbuffer (MSB first).
 void bitbuffer_add_bit(bitbuffer_t *bits, int bit);
 
+/// Add the count (up to 32) low bits of word at the end of the bitbuffer (MSB first).
+///
+/// Same result as adding each bit with bitbuffer_add_bit().
+void bitbuffer_add_bits(bitbuffer_t *bits, uint32_t word, unsigned count);
+
 /// Add a new row to the bitbuffer.
 void bitbuffer_add_row(bitbuffer_t *bits);
 
@@ -106,6 +153,7 @@ void bitbuffer_parse(bitbuffer_t *bits, const char *code);
 /// of the row if no match is found.
 /// The pattern starts in the high bit. For example if searching for 011011
 /// the byte pointed to by 'pattern' would be 0xAC. (011011xx).
+/// With shared preambles the result is looked up, see bitbuffer_share_preambles().
 unsigned bitbuffer_search(bitbuffer_t *bitbuffer, unsigned row, unsigned start,
         const uint8_t *pattern, unsigned pattern_bits_len);
 
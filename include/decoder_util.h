@@ -31,6 +31,21 @@
 /// Create a new r_device, copy from dev_template if not NULL.
 r_device *create_device(r_device const *dev_template);
 
+/// Create a new r_device, copy from dev_template if not NULL, with zeroed user data if user_data_size is not 0.
+r_device *decoder_create(r_device const *dev_template, unsigned user_data_size);
+
+/// Get the user data of a decoder created with decoder_create().
+void *decoder_user_data(r_device *decoder);
+
+/// Make the state of a registered decoder known to the decoder helpers, replaces an earlier state of the same decoder.
+void decoder_link_state(r_device_state *state);
+
+/// Forget the state of a decoder being unregistered.
+void decoder_unlink_state(r_device_state *state);
+
+/// Get the state linked to a decoder, NULL if the decoder is not registered.
+r_device_state *decoder_state(r_device const *decoder);
+
 /// Output data.
 void decoder_output_data(r_device *decoder, data_t *data);
 
@@ -17,4 +17,45 @@
 /// Analyze and print result.
 void pulse_analyzer(pulse_data_t *data, int package_type);
 
+#define PULSE_TIMING_BINS 16
+
+/// Range of widths [samples] in one fused histogram bin.
+typedef struct pulse_timing_range {
+    int min;
+    int max;
+} pulse_timing_range_t;
+
+/// Coding families a pulse train might carry.
+enum pulse_coding {
+    PULSE_CODING_PWM   = 1 << 0, ///< Data in the pulse widths.
+    PULSE_CODING_PPM   = 1 << 1, ///< Data in the gap widths.
+    PULSE_CODING_OTHER = 1 << 2, ///< PCM, Manchester, DMC, PIWM, NRZS, ...
+    PULSE_CODING_ALL   = PULSE_CODING_PWM | PULSE_CODING_PPM | PULSE_CODING_OTHER,
+};
+
+/// Coarse timing fingerprint of a pulse train, every pulse and gap width
+/// lies in one of the ranges.
+typedef struct pulse_timing {
+    unsigned codings; ///< Plausible codings, enum pulse_coding bits.
+    unsigned pulse_count;
+    unsigned gap_count;
+    pulse_timing_range_t pulses[PULSE_TIMING_BINS];
+    pulse_timing_range_t gaps[PULSE_TIMING_BINS];
+} pulse_timing_t;
+
+/// Build the fused pulse and gap width histograms of a pulse train and
+/// classify the codings it might carry.
+void pulse_timing_analyze(pulse_timing_t *timing, pulse_data_t const *data);
+
+/// Check if two widths are far enough apart to always fall into separate bins
+/// of pulse_timing_analyze(), even with jitter. Only then does a train with a
+/// single bin of data widths rule out a PWM or PPM coding with these widths.
+int pulse_timing_separable(float short_width, float long_width);
+
+/// Check if the train might have a pulse wider than lower and narrower than upper [samples].
+int pulse_timing_has_pulse(pulse_timing_t const *timing, int lower, int upper);
+
+/// Check if the train might have a gap wider than lower and narrower than upper [samples].
+int pulse_timing_has_gap(pulse_timing_t const *timing, int lower, int upper);
+
 #endif /* INCLUDE_PULSE_ANALYZER_H_ */
@@ -32,6 +32,12 @@
 #define PD_MAX_PULSE_MS                                                        \
   100 // Pulse width in ms to exceed to declare End Of Package (e.g. for non OOK
       // packages)
+#define PD_WIDTH_ESCAPE                                                        \
+  0xffff // Stored width marking an entry kept in the long width table
+#define PD_MAX_LONG_WIDTHS                                                     \
+  16 // Maximum number of escaped widths per package, longer ones saturate
+#define PD_LONG_GAP                                                            \
+  0x8000 // Flag in long_index for a gap, otherwise a pulse
 
 /// Data for a compact representation of generic pulse train.
 typedef struct pulse_data {
@@ -42,9 +48,15 @@ typedef struct pulse_data {
   unsigned start_ago;   ///< Start of first pulse in number of samples ago.
   unsigned end_ago;     ///< End of last pulse in number of samples ago.
   unsigned int num_pulses;
-  int pulse[PD_MAX_PULSES]; ///< Width of pulses (high) in number of samples.
-  int gap[PD_MAX_PULSES];   ///< Width of gaps between pulses (low) in number of
-                            ///< samples.
+  uint16_t pulse[PD_MAX_PULSES]; ///< Width of pulses (high) in number of
+                                 ///< samples, use pulse_data_get_pulse().
+  uint16_t gap[PD_MAX_PULSES];   ///< Width of gaps between pulses (low) in
+                                 ///< number of samples, use pulse_data_get_gap().
+  unsigned num_long;             ///< Number of escaped widths.
+  uint16_t long_index[PD_MAX_LONG_WIDTHS]; ///< Index of each escaped width,
+                                           ///< with PD_LONG_GAP for gaps.
+  uint32_t long_width[PD_MAX_LONG_WIDTHS]; ///< Escaped widths in number of
+                                           ///< samples.
   int ook_low_estimate;  ///< Estimate for the OOK low level (base noise level)
                          ///< at beginning of package.
   int ook_high_estimate; ///< Estimate for the OOK high level at end of package.
@@ -62,18 +74,81 @@ typedef struct pulse_data {
   //
   int signalRssi;
   unsigned long signalDuration;
+  int signalRssiMin; ///< Lowest rssi sampled during capture, rssi_db holds
+                     ///< the mean while the signal was above the threshold.
+  int signalRssiMax; ///< Highest rssi sampled during capture.
 #ifdef SIGNAL_RSSI
-  int rssi[PD_MAX_PULSES];
+  int8_t rssi[PD_MAX_PULSES];
 #endif
 
 } pulse_data_t;
 
+/// Width stored for a given long_index key, saturated if it was not kept.
+static inline unsigned pulse_data_long_width(pulse_data_t const *data, unsigned key)
+{
+    for (unsigned i = 0; i < data->num_long; ++i) {
+        if (data->long_index[i] == key)
+            return data->long_width[i];
+    }
+    return PD_WIDTH_ESCAPE;
+}
+
+/// Width of pulse n in number of samples.
+static inline int pulse_data_get_pulse(pulse_data_t const *data, unsigned n)
+{
+    unsigned width = data->pulse[n];
+    return width != PD_WIDTH_ESCAPE ? (int)width : (int)pulse_data_long_width(data, n);
+}
+
+/// Width of gap n in number of samples.
+static inline int pulse_data_get_gap(pulse_data_t const *data, unsigned n)
+{
+    unsigned width = data->gap[n];
+    return width != PD_WIDTH_ESCAPE ? (int)width : (int)pulse_data_long_width(data, n | PD_LONG_GAP);
+}
+
+/// Store a width, escaping it to the long width table if it does not fit.
+static inline void pulse_data_store_width(pulse_data_t *data, uint16_t *slot, unsigned key, unsigned width)
+{
+    if (width < PD_WIDTH_ESCAPE) {
+        *slot = (uint16_t)width;
+        return;
+    }
+    unsigned i = 0;
+    while (i < data->num_long && data->long_index[i] != key)
+        ++i;
+    if (i < PD_MAX_LONG_WIDTHS) {
+        if (i == data->num_long) {
+            data->long_index[i] = (uint16_t)key;
+            data->num_long++;
+        }
+        data->long_width[i] = width;
+    }
+    *slot = PD_WIDTH_ESCAPE;
+}
+
+/// Set the width of pulse n in number of samples.
+static inline void pulse_data_set_pulse(pulse_data_t *data, unsigned n, unsigned width)
+{
+    pulse_data_store_width(data, &data->pulse[n], n, width);
+}
+
+/// Set the width of gap n in number of samples.
+static inline void pulse_data_set_gap(pulse_data_t *data, unsigned n, unsigned width)
+{
+    pulse_data_store_width(data, &data->gap[n], n | PD_LONG_GAP, width);
+}
+
 /// Clear the content of a pulse_data_t structure.
 void pulse_data_clear(pulse_data_t *data);
 
 /// Shift out part of the data to make room for more.
 void pulse_data_shift(pulse_data_t *data);
 
+/// Move pulses count to total - 1 of a train being captured to the start of rest, clearing them in data.
+/// Returns the duration of the moved pulses and gaps in number of samples.
+unsigned long pulse_data_split(pulse_data_t *data, pulse_data_t *rest, unsigned count, unsigned total);
+
 /// Print the content of a pulse_data_t structure (for debug).
 void pulse_data_print(pulse_data_t const *data);
 
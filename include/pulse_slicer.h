@@ -14,9 +14,66 @@
 #ifndef INCLUDE_PULSE_SLICER_H_
 #define INCLUDE_PULSE_SLICER_H_
 
+#include <stdint.h>
+
+#include "bitbuffer.h"
+#include "pulse_data.h"
 #include "pulse_detect.h"
 #include "r_device.h"
 
+/// Working state of the slicers, owned by the caller.
+///
+/// Each task or receiver slicing concurrently needs its own context.
+/// The bitbuffers must be zero initialized before first use.
+///
+/// A group hands every event of a slicer call to decoders with the same
+/// modulation and timings as the device passed, each decoding its own copy.
+/// Only slicers that do not reuse the bitbuffer after an event support groups.
+typedef struct pulse_slicer_ctx {
+    bitbuffer_t bits;       ///< bits of the current slice
+    bitbuffer_t copy;       ///< copy handed to all but the last decoder of a group
+    r_device_state *const *group; ///< decoders sharing the slice, NULL if none
+    unsigned group_len;     ///< number of decoders in the group
+    uint8_t symbols[PD_MAX_PULSES]; ///< quantized widths of the current train
+    bitbuffer_preambles_t preambles; ///< search results shared by the decoders of an event
+} pulse_slicer_ctx_t;
+
+/// Sample rate of the pulse trains handed to the slicers on the ESP, 1 sample per us.
+#define PULSE_SLICER_SAMPLE_RATE 1000000
+
+/// Lower and upper bounds (non inclusive) of the symbols of a PPM or PWM slicer.
+typedef struct pulse_slicer_bounds {
+    int zero_l, zero_u;
+    int one_l, one_u;
+    int sync_l, sync_u;
+} pulse_slicer_bounds_t;
+
+/// Integer timings of a decoder at one sample rate.
+///
+/// Computed once when the decoder is registered, so the slicers need
+/// no floating point on each pulse train.
+typedef struct pulse_slicer_timing {
+    uint32_t sample_rate; ///< sample rate the timings were computed for, 0 if none
+    int too_low;          ///< a nonzero width rounds to zero samples at this rate
+    int s_short;
+    int s_long;
+    int s_reset;
+    int s_gap;
+    int s_sync;
+    int s_tolerance;
+    int64_t r_short;      ///< reciprocal of the short width in samples, Q32 fixed point
+    int64_t r_long;       ///< reciprocal of the long width in samples, Q32 fixed point
+    pulse_slicer_bounds_t ppm;
+    pulse_slicer_bounds_t pwm;
+} pulse_slicer_timing_t;
+
+/// Compute the integer timings of a decoder.
+///
+/// @param timing the timings to fill in
+/// @param device Modulation parameters in us
+/// @param sample_rate sample rate of the pulse trains
+void pulse_slicer_timing_init(pulse_slicer_timing_t *timing, r_device const *device, uint32_t sample_rate);
+
 /// Demodulate a Pulse Code Modulation signal.
 ///
 /// Demodulate a Pulse Code Modulation (PCM) signal where bit width
@@ -27,15 +84,16 @@
 /// - Presence of a pulse equals 1
 /// - Absence of a pulse equals 0
 ///
+/// @param ctx Slicer state of the calling task
 /// @param pulses The pulse sequence to demodulate
-/// @param device Modulation parameters of
+/// @param state State of a registered decoder with modulation parameters of
 /// - short_width: Nominal width of pulse [us]
 /// - long_width:  Nominal width of bit period [us]
 /// - gap_limit:   Maximum gap size before new row of bits (optional) [us]
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// - tolerance:   Maximum deviation from nominal widths (optional, default 25%) [us]
 /// @return number of events processed
-int pulse_slicer_pcm(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_pcm(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device_state *state);
 
 /// Demodulate a Pulse Position Modulation signal.
 ///
@@ -45,15 +103,16 @@ int pulse_slicer_pcm(pulse_data_t const *pulses, r_device *device);
 /// - Short gap will add a 0 bit
 /// - Long  gap will add a 1 bit
 ///
+/// @param ctx Slicer state of the calling task
 /// @param pulses The pulse sequence to demodulate
-/// @param device Modulation parameters of
+/// @param state State of a registered decoder with modulation parameters of
 /// - short_width: Nominal width of '0' [us]
 /// - long_width:  Nominal width of '1' [us]
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// - gap_limit:   Maximum gap size before new row of bits [us]
 /// - tolerance:   Maximum deviation from nominal widths (optional, raw if 0) [us]
 /// @return number of events processed
-int pulse_slicer_ppm(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_ppm(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device_state *state);
 
 /// Demodulate a Pulse Width Modulation signal.
 ///
@@ -63,8 +122,9 @@ int pulse_slicer_ppm(pulse_data_t const *pulses, r_device *device);
 /// - Long pulse will add a 0 bit
 /// - Sync pulse (optional) will add a new row to bitbuffer
 ///
+/// @param ctx Slicer state of the calling task
 /// @param pulses The pulse sequence to demodulate
-/// @param device Modulation parameters of
+/// @param state State of a registered decoder with modulation parameters of
 /// - short_width: Nominal width of '1' [us]
 /// - long_width:  Nominal width of '0' [us]
 /// - reset_limit: Maximum gap size before End Of Message [us].
@@ -72,7 +132,7 @@ int pulse_slicer_ppm(pulse_data_t const *pulses, r_device *device);
 /// - sync_width:  Nominal width of sync pulse (optional) [us]
 /// - tolerance:   Maximum deviation from nominal widths (optional, raw if 0) [us]
 /// @return number of events processed
-int pulse_slicer_pwm(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_pwm(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device_state *state);
 
 /// Demodulate a Manchester encoded signal with a hardcoded zerobit in front.
 ///
@@ -84,13 +144,14 @@ int pulse_slicer_pwm(pulse_data_t const *pulses, r_device *device);
 /// - Rising edge means bit = 0
 /// - Falling edge means bit = 1
 ///
+/// @param ctx Slicer state of the calling task
 /// @param pulses The pulse sequence to demodulate
-/// @param device Modulation parameters of
+/// @param state State of a registered decoder with modulation parameters of
 /// - short_width: Nominal width of clock half period [us]
 /// - long_width:  Not used
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// @return number of events processed
-int pulse_slicer_manchester_zerobit(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_manchester_zerobit(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device_state *state);
 
 /// Demodulate a Differential Manchester Coded signal.
 ///
@@ -106,46 +167,49 @@ int pulse_slicer_manchester_zerobit(pulse_data_t const *pulses, r_device *device
 ///     ^       ^       ^       ^       ^  clock cycle
 ///     |   1   |   1   |   0   |   0   |  translates as
 ///
+/// @param ctx Slicer state of the calling task
 /// @param pulses The pulse sequence to demodulate
-/// @param device Modulation parameters of
+/// @param state State of a registered decoder with modulation parameters of
 /// - short_width: Width in samples of '1' [us]
 /// - long_width:  Width in samples of '0' [us]
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// - tolerance:   Maximum deviation from nominal widths [us]
 /// @return number of events processed
-int pulse_slicer_dmc(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_dmc(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device_state *state);
 
 /// Demodulate a raw Pulse Interval and Width Modulation signal.
 ///
 /// Each level shift is a new bit.
 /// A short interval is a logic 1, a long interval a logic 0
 ///
+/// @param ctx Slicer state of the calling task
 /// @param pulses The pulse sequence to demodulate
-/// @param device Modulation parameters of
+/// @param state State of a registered decoder with modulation parameters of
 /// - short_width: Nominal width of a bit [us]
 /// - long_width:  Maximum width of a run of bits [us]
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// - tolerance:   Maximum deviation from nominal widths [us]
 /// @return number of events processed
-int pulse_slicer_piwm_raw(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_piwm_raw(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device_state *state);
 
 /// Demodulate a differential Pulse Interval and Width Modulation signal.
 ///
 /// Each level shift is a new bit.
 /// A short interval is a logic 1, a long interval a logic 0
 ///
+/// @param ctx Slicer state of the calling task
 /// @param pulses The pulse sequence to demodulate
-/// @param device Modulation parameters of
+/// @param state State of a registered decoder with modulation parameters of
 /// - short_width: Nominal width of '1' [us]
 /// - long_width:  Nominal width of '0' [us]
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// - tolerance:   Maximum deviation from nominal widths [us]
 /// @return number of events processed
-int pulse_slicer_piwm_dc(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_piwm_dc(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device_state *state);
 
-int pulse_slicer_nrzs(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_nrzs(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device_state *state);
 
-int pulse_slicer_osv1(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_osv1(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device_state *state);
 
 /// Simulate demodulation using a given signal code string.
 ///
@@ -154,8 +218,8 @@ int pulse_slicer_osv1(pulse_data_t const *pulses, r_device *device);
 /// separated with a slash "/" character. Whitespace is ignored.
 ///
 /// @param code The pulse sequence to demodulate in text format
-/// @param device Device params are disregarded.
+/// @param state Decoder state, device params are disregarded.
 /// @return number of events processed
-int pulse_slicer_string(const char *code, r_device *device);
+int pulse_slicer_string(const char *code, r_device_state *state);
 
 #endif /* INCLUDE_PULSE_SLICER_H_ */
@@ -16,9 +16,11 @@
 
 struct r_cfg;
 struct r_device;
+struct r_device_state;
 struct data;
 struct pulse_data;
 struct list;
+struct dm_state;
 struct mg_mgr;
 
 /* general */
@@ -33,11 +35,11 @@ void r_free_cfg(struct r_cfg *cfg);
 
 /* device decoder protocols */
 
-void register_protocol(struct r_cfg *cfg, struct r_device *r_dev, char *arg);
+void register_protocol(struct r_cfg *cfg, struct r_device const *r_dev, char *arg);
 
-void free_protocol(struct r_device *r_dev);
+void free_protocol(struct r_device_state *state);
 
-void unregister_protocol(struct r_cfg *cfg, struct r_device *r_dev);
+void unregister_protocol(struct r_cfg *cfg, struct r_device const *r_dev);
 
 void register_all_protocols(struct r_cfg *cfg, unsigned disabled);
 
@@ -51,9 +53,9 @@ char const **well_known_output_fields(struct r_cfg *cfg);
 
 char const **determine_csv_fields(struct r_cfg *cfg, char const *const *well_known, int *num_fields);
 
-int run_ook_demods(struct list *r_devs, struct pulse_data *pulse_data);
+int run_ook_demods(struct dm_state *demod, struct pulse_data *pulse_data);
 
-int run_fsk_demods(struct list *r_devs, struct pulse_data *fsk_pulse_data);
+int run_fsk_demods(struct dm_state *demod, struct pulse_data *fsk_pulse_data);
 
 /* handlers */
 
@@ -61,9 +63,9 @@ void r_redirect_logging(struct r_cfg *cfg);
 
 void event_occurred_handler(struct r_cfg *cfg, struct data *data);
 
-void log_device_handler(struct r_device *r_dev, int level, struct data *data);
+void log_device_handler(struct r_device_state *state, int level, struct data *data);
 
-void data_acquired_handler(struct r_device *r_dev, struct data *data);
+void data_acquired_handler(struct r_device_state *state, struct data *data);
 
 struct data *create_report_data(struct r_cfg *cfg, int level);
 
@@ -53,11 +53,14 @@ enum decode_return_codes {
 
 struct bitbuffer;
 struct data;
+struct pulse_slicer_timing;
 
-/** Device protocol decoder struct. */
-typedef struct r_device {
-    unsigned protocol_num; ///< fixed sequence number, assigned in main().
+/** Device protocol decoder struct.
 
+    The decoders define these as const, so they stay in flash. Everything that
+    changes at run time is kept in the r_device_state linked at registration.
+*/
+typedef struct r_device {
     /* information provided by each decoder */
     char const *name;
     unsigned modulation;
@@ -73,11 +76,20 @@ typedef struct r_device {
     unsigned disabled; ///< 0: default enabled, 1: default disabled, 2: disabled, 3: disabled and hidden
     char const *const *fields; ///< List of fields this decoder produces; required for CSV output. NULL-terminated.
 
+    /* private for decoders created at run time, see decoder_create() */
+    void *decode_ctx; ///< user data, handed to the state at registration
+} r_device;
+
+/** Mutable state of a registered decoder, see register_protocol(). */
+typedef struct r_device_state {
+    r_device const *device; ///< the decoder, usually const in flash
+    unsigned protocol_num;  ///< fixed sequence number, assigned at registration.
+
     /* public for each decoder */
     int verbose;
     int verbose_bits;
-    void (*log_fn)(struct r_device *decoder, int level, struct data *data);
-    void (*output_fn)(struct r_device *decoder, struct data *data);
+    void (*log_fn)(struct r_device_state *state, int level, struct data *data);
+    void (*output_fn)(struct r_device_state *state, struct data *data);
 
     /* Decoder results / statistics */
     unsigned decode_events;
@@ -88,6 +100,10 @@ typedef struct r_device {
     /* private for flex decoder and output callback */
     void *decode_ctx;
     void *output_ctx;
-} r_device;
+
+    /* private for the pulse slicers */
+    struct pulse_slicer_timing *slicer_timing; ///< integer timings, computed by register_protocol()
+    r_device *created; ///< decoder made by create_fn, owned by the state
+} r_device_state;
 
 #endif /* INCLUDE_R_DEVICE_H_ */
@@ -14,8 +14,37 @@
 // #include "samp_grab.h"
 // #include "am_analyze.h"
 #include "rtl_433.h"
+#include "r_device.h"
+#include "pulse_slicer.h"
 #include "compat_time.h"
 
+typedef int (*demod_slicer_fn)(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device_state *state);
+
+/// Pulse train timing check run before the slicer of a decoder.
+enum demod_prefilter {
+    DEMOD_PREFILTER_NONE,       ///< Always slice.
+    DEMOD_PREFILTER_PULSE,      ///< Some pulse near short or long width (PWM).
+    DEMOD_PREFILTER_GAP,        ///< Some gap near short or long width (PPM).
+    DEMOD_PREFILTER_MANCHESTER, ///< Some pulse between short and twice short width.
+};
+
+/// Registered decoder with the slicer for its modulation.
+typedef struct demod_entry {
+    demod_slicer_fn slicer;
+    r_device_state *state;
+    unsigned priority;
+    r_device_state **group; ///< Decoders sharing the slice of state including it, NULL if none.
+    unsigned group_len; ///< Number of decoders decoding the slice.
+    unsigned prefilter; ///< enum demod_prefilter
+    unsigned coding;    ///< enum pulse_coding bit of the slicer
+} demod_entry_t;
+
+/// Decoders ordered by priority and grouped by modulation, see register_protocol().
+typedef struct demod_list {
+    demod_entry_t *entries;
+    unsigned len;
+} demod_list_t;
+
 struct dm_state {
     /*
     float auto_level;
@@ -51,9 +80,12 @@ struct dm_state {
     list_t dumper;
     */
     /* Protocol states */
-    list_t r_devs;
+    list_t r_devs; ///< r_device_state of the registered decoders.
+    demod_list_t ook_demods; ///< Dispatch list of the OOK decoders in r_devs.
+    demod_list_t fsk_demods; ///< Dispatch list of the FSK decoders in r_devs.
 
-    pulse_data_t    pulse_data;
+    pulse_data_t    *pulse_data; ///< Pulse train being decoded, owned by the decoder task.
+    pulse_slicer_ctx_t slicer_ctx; ///< Slicer state of the decoder task.
     /*
     pulse_data_t    fsk_pulse_data;
     unsigned frame_event_count;
@@ -112,7 +112,7 @@ typedef struct r_cfg {
   time_t stats_time;
   int no_default_devices;
   */
-  struct r_device *devices;
+  struct r_device const **devices; ///< the decoders, usually const in flash
   uint16_t num_r_devices;
 
   // list_t data_tags;
@@ -138,6 +138,8 @@ typedef struct r_cfg {
   //
   char *messageBuffer; // message buffer for message callback
   int bufferSize;      // size of message buffer for message callback
+  int dedup_window;    // window in ms to drop duplicate messages, 0 is off
+  unsigned dedup_suppressed; // number of duplicate messages dropped
   /**
    * callback to controlling program to be executed when a message is received.
    * Object point passed is a pointer to a JSON formatted message for
@@ -299,7 +299,7 @@
   #define NUMOFDEVICES 5
 #endif
 
-#define DECL(name) extern r_device name;
+#define DECL(name) extern r_device const name;
 DEVICES
 #undef DECL
 
@@ -11,29 +11,98 @@
 
 #include "bit_util.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
+// Word operations work on aligned 32-bit words (the ESP32 faults on unaligned
+// loads), byte lanes are independent so the byte order does not matter.
+#if defined(__GNUC__)
+#define BIT_UTIL_ASSUME_ALIGNED4(p) __builtin_assume_aligned((p), 4)
+#else
+#define BIT_UTIL_ASSUME_ALIGNED4(p) (p)
+#endif
+
+// Use the parity builtin only where it maps to a popcount instruction.
+#if defined(__GNUC__) && defined(__POPCNT__)
+#define BIT_UTIL_HAVE_POPCOUNT 1
+#endif
+
+/// Number of leading bytes to process singly before p is word aligned, at most n.
+static inline unsigned head_bytes(uint8_t const *p, unsigned n)
+{
+    unsigned head = (4 - ((uintptr_t)p & 3)) & 3;
+    return head < n ? head : n;
+}
+
+static inline uint32_t load_word(uint8_t const *p)
+{
+    uint32_t w;
+    memcpy(&w, BIT_UTIL_ASSUME_ALIGNED4(p), sizeof(w));
+    return w;
+}
+
+static inline void store_word(uint8_t *p, uint32_t w)
+{
+    memcpy(BIT_UTIL_ASSUME_ALIGNED4(p), &w, sizeof(w));
+}
+
+static uint8_t const reverse8_table[256] = {
+        0x00, 0x80, 0x40, 0xc0, 0x20, 0xa0, 0x60, 0xe0, 0x10, 0x90, 0x50, 0xd0, 0x30, 0xb0, 0x70, 0xf0,
+        0x08, 0x88, 0x48, 0xc8, 0x28, 0xa8, 0x68, 0xe8, 0x18, 0x98, 0x58, 0xd8, 0x38, 0xb8, 0x78, 0xf8,
+        0x04, 0x84, 0x44, 0xc4, 0x24, 0xa4, 0x64, 0xe4, 0x14, 0x94, 0x54, 0xd4, 0x34, 0xb4, 0x74, 0xf4,
+        0x0c, 0x8c, 0x4c, 0xcc, 0x2c, 0xac, 0x6c, 0xec, 0x1c, 0x9c, 0x5c, 0xdc, 0x3c, 0xbc, 0x7c, 0xfc,
+        0x02, 0x82, 0x42, 0xc2, 0x22, 0xa2, 0x62, 0xe2, 0x12, 0x92, 0x52, 0xd2, 0x32, 0xb2, 0x72, 0xf2,
+        0x0a, 0x8a, 0x4a, 0xca, 0x2a, 0xaa, 0x6a, 0xea, 0x1a, 0x9a, 0x5a, 0xda, 0x3a, 0xba, 0x7a, 0xfa,
+        0x06, 0x86, 0x46, 0xc6, 0x26, 0xa6, 0x66, 0xe6, 0x16, 0x96, 0x56, 0xd6, 0x36, 0xb6, 0x76, 0xf6,
+        0x0e, 0x8e, 0x4e, 0xce, 0x2e, 0xae, 0x6e, 0xee, 0x1e, 0x9e, 0x5e, 0xde, 0x3e, 0xbe, 0x7e, 0xfe,
+        0x01, 0x81, 0x41, 0xc1, 0x21, 0xa1, 0x61, 0xe1, 0x11, 0x91, 0x51, 0xd1, 0x31, 0xb1, 0x71, 0xf1,
+        0x09, 0x89, 0x49, 0xc9, 0x29, 0xa9, 0x69, 0xe9, 0x19, 0x99, 0x59, 0xd9, 0x39, 0xb9, 0x79, 0xf9,
+        0x05, 0x85, 0x45, 0xc5, 0x25, 0xa5, 0x65, 0xe5, 0x15, 0x95, 0x55, 0xd5, 0x35, 0xb5, 0x75, 0xf5,
+        0x0d, 0x8d, 0x4d, 0xcd, 0x2d, 0xad, 0x6d, 0xed, 0x1d, 0x9d, 0x5d, 0xdd, 0x3d, 0xbd, 0x7d, 0xfd,
+        0x03, 0x83, 0x43, 0xc3, 0x23, 0xa3, 0x63, 0xe3, 0x13, 0x93, 0x53, 0xd3, 0x33, 0xb3, 0x73, 0xf3,
+        0x0b, 0x8b, 0x4b, 0xcb, 0x2b, 0xab, 0x6b, 0xeb, 0x1b, 0x9b, 0x5b, 0xdb, 0x3b, 0xbb, 0x7b, 0xfb,
+        0x07, 0x87, 0x47, 0xc7, 0x27, 0xa7, 0x67, 0xe7, 0x17, 0x97, 0x57, 0xd7, 0x37, 0xb7, 0x77, 0xf7,
+        0x0f, 0x8f, 0x4f, 0xcf, 0x2f, 0xaf, 0x6f, 0xef, 0x1f, 0x9f, 0x5f, 0xdf, 0x3f, 0xbf, 0x7f, 0xff,
+};
+
 uint8_t reverse8(uint8_t x)
 {
-    x = (x & 0xF0) >> 4 | (x & 0x0F) << 4;
-    x = (x & 0xCC) >> 2 | (x & 0x33) << 2;
-    x = (x & 0xAA) >> 1 | (x & 0x55) << 1;
-    return x;
+    return reverse8_table[x];
 }
 
 uint32_t reverse32(uint32_t x)
 {
-    uint32_t ret;
-    uint8_t const* xp = (uint8_t*)&x;
-    ret = (uint32_t) reverse8(xp[0]) << 24 | reverse8(xp[1]) << 16 | reverse8(xp[2]) << 8 | reverse8(xp[3]);
-    return ret;
+    x = (x & 0xFFFF0000) >> 16 | (x & 0x0000FFFF) << 16;
+    x = (x & 0xFF00FF00) >> 8 | (x & 0x00FF00FF) << 8;
+    x = (x & 0xF0F0F0F0) >> 4 | (x & 0x0F0F0F0F) << 4;
+    x = (x & 0xCCCCCCCC) >> 2 | (x & 0x33333333) << 2;
+    x = (x & 0xAAAAAAAA) >> 1 | (x & 0x55555555) << 1;
+    return x;
+}
+
+/// Reverse the bits in each nibble of the four byte lanes.
+static inline uint32_t reflect4_lanes(uint32_t w)
+{
+    w = (w & 0xCCCCCCCC) >> 2 | (w & 0x33333333) << 2;
+    w = (w & 0xAAAAAAAA) >> 1 | (w & 0x55555555) << 1;
+    return w;
 }
 
 void reflect_bytes(uint8_t message[], unsigned num_bytes)
 {
-    for (unsigned i = 0; i < num_bytes; ++i) {
+    unsigned i    = 0;
+    unsigned head = head_bytes(message, num_bytes);
+    for (; i < head; ++i) {
+        message[i] = reverse8(message[i]);
+    }
+    for (; i + 4 <= num_bytes; i += 4) {
+        uint32_t w = load_word(&message[i]);
+        w          = (w & 0xF0F0F0F0) >> 4 | (w & 0x0F0F0F0F) << 4;
+        store_word(&message[i], reflect4_lanes(w));
+    }
+    for (; i < num_bytes; ++i) {
         message[i] = reverse8(message[i]);
     }
 }
@@ -47,7 +116,15 @@ uint8_t reflect4(uint8_t x)
 
 void reflect_nibbles(uint8_t message[], unsigned num_bytes)
 {
-    for (unsigned i = 0; i < num_bytes; ++i) {
+    unsigned i    = 0;
+    unsigned head = head_bytes(message, num_bytes);
+    for (; i < head; ++i) {
+        message[i] = reflect4(message[i]);
+    }
+    for (; i + 4 <= num_bytes; i += 4) {
+        store_word(&message[i], reflect4_lanes(load_word(&message[i])));
+    }
+    for (; i < num_bytes; ++i) {
         message[i] = reflect4(message[i]);
     }
 }
@@ -129,23 +206,19 @@ unsigned extract_bytes_uart_parity(uint8_t const *message, unsigned offset_bits,
     return ret;
 }
 
-static unsigned symbol_match(uint8_t const *message, unsigned offset_bits, unsigned num_bits, uint32_t symbol)
+/// Match a symbol (MSB aligned bits, length in the low 5 bits) against a bit window.
+static inline unsigned symbol_match_window(uint32_t window, unsigned num_bits, uint32_t symbol)
 {
     unsigned symbol_len = symbol & 0x1f;
 
-    // check required len
-    if (num_bits < symbol_len) {
+    // check required len, an empty symbol never matches
+    if (num_bits < symbol_len || symbol_len == 0) {
         return 0;
     }
 
-    // match each bit otherwise abort
-    for (unsigned pos = 0; pos < symbol_len; ++pos) {
-        unsigned m_pos = offset_bits + pos;
-        unsigned m_bit = message[m_pos / 8] >> (7 - (m_pos % 8));
-        unsigned s_bit = symbol >> (31 - pos);
-        if ((m_bit & 1) != (s_bit & 1)) {
-            return 0;
-        }
+    // match all bits at once
+    if ((window ^ symbol) & (0xffffffff << (32 - symbol_len))) {
+        return 0;
     }
 
     return symbol_len;
@@ -159,28 +232,47 @@ unsigned extract_bits_symbols(uint8_t const *message, unsigned offset_bits, unsi
 
     unsigned dst_len = 0;
 
+    // slide a MSB aligned bit reservoir over the message, refilled a byte at a time
+    unsigned pos       = offset_bits / 8;
+    unsigned end       = (offset_bits + num_bits + 7) / 8;
+    unsigned acc_bits  = 0;
+    uint64_t acc       = 0;
+    unsigned skip_bits = offset_bits % 8;
+
     while (num_bits >= 1) {
+        while (acc_bits <= 56 && pos < end) {
+            acc |= (uint64_t)message[pos++] << (56 - acc_bits);
+            acc_bits += 8;
+        }
+        if (skip_bits) {
+            acc <<= skip_bits;
+            acc_bits -= skip_bits;
+            skip_bits = 0;
+            continue;
+        }
+        uint32_t window = (uint32_t)(acc >> 32);
+        unsigned len;
         // TODO: match the longest symbol first
-        if (symbol_match(message, offset_bits, num_bits, sync)) {
-            offset_bits += sync_len;
-            num_bits -= sync_len;
+        if (symbol_match_window(window, num_bits, sync)) {
+            len = sync_len;
             // just skip
         }
-        else if (symbol_match(message, offset_bits, num_bits, zero)) {
-            offset_bits += zero_len;
-            num_bits -= zero_len;
+        else if (symbol_match_window(window, num_bits, zero)) {
+            len = zero_len;
             // no need to set a zero
             dst_len += 1;
         }
-        else if (symbol_match(message, offset_bits, num_bits, one)) {
-            offset_bits += one_len;
-            num_bits -= one_len;
+        else if (symbol_match_window(window, num_bits, one)) {
+            len = one_len;
             dst[dst_len / 8] |= 0x80 >> (dst_len % 8);
             dst_len += 1;
         }
         else {
             break;
         }
+        acc <<= len;
+        acc_bits -= len;
+        num_bits -= len;
     }
 
     // fprintf(stderr, "extract_bits_symbols: %x %x %x : %u (%u)\n", zero, one, sync, dst_len, num_bits);
@@ -225,7 +317,262 @@ uint8_t crc7(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uint8
     return remainder >> 1 & 0x7f; // discard the LSB
 }
 
-uint8_t crc8(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uint8_t init)
+// CRC tables of the polynomials most decoders use, the remainder of each byte value.
+// Generated with the bit-serial loops below, const tables stay in flash on the ESP32.
+
+static uint8_t const crc8_table_31[256] = {
+        0x00, 0x31, 0x62, 0x53, 0xc4, 0xf5, 0xa6, 0x97, 0xb9, 0x88, 0xdb, 0xea, 0x7d, 0x4c, 0x1f, 0x2e,
+        0x43, 0x72, 0x21, 0x10, 0x87, 0xb6, 0xe5, 0xd4, 0xfa, 0xcb, 0x98, 0xa9, 0x3e, 0x0f, 0x5c, 0x6d,
+        0x86, 0xb7, 0xe4, 0xd5, 0x42, 0x73, 0x20, 0x11, 0x3f, 0x0e, 0x5d, 0x6c, 0xfb, 0xca, 0x99, 0xa8,
+        0xc5, 0xf4, 0xa7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7c, 0x4d, 0x1e, 0x2f, 0xb8, 0x89, 0xda, 0xeb,
+        0x3d, 0x0c, 0x5f, 0x6e, 0xf9, 0xc8, 0x9b, 0xaa, 0x84, 0xb5, 0xe6, 0xd7, 0x40, 0x71, 0x22, 0x13,
+        0x7e, 0x4f, 0x1c, 0x2d, 0xba, 0x8b, 0xd8, 0xe9, 0xc7, 0xf6, 0xa5, 0x94, 0x03, 0x32, 0x61, 0x50,
+        0xbb, 0x8a, 0xd9, 0xe8, 0x7f, 0x4e, 0x1d, 0x2c, 0x02, 0x33, 0x60, 0x51, 0xc6, 0xf7, 0xa4, 0x95,
+        0xf8, 0xc9, 0x9a, 0xab, 0x3c, 0x0d, 0x5e, 0x6f, 0x41, 0x70, 0x23, 0x12, 0x85, 0xb4, 0xe7, 0xd6,
+        0x7a, 0x4b, 0x18, 0x29, 0xbe, 0x8f, 0xdc, 0xed, 0xc3, 0xf2, 0xa1, 0x90, 0x07, 0x36, 0x65, 0x54,
+        0x39, 0x08, 0x5b, 0x6a, 0xfd, 0xcc, 0x9f, 0xae, 0x80, 0xb1, 0xe2, 0xd3, 0x44, 0x75, 0x26, 0x17,
+        0xfc, 0xcd, 0x9e, 0xaf, 0x38, 0x09, 0x5a, 0x6b, 0x45, 0x74, 0x27, 0x16, 0x81, 0xb0, 0xe3, 0xd2,
+        0xbf, 0x8e, 0xdd, 0xec, 0x7b, 0x4a, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xc2, 0xf3, 0xa0, 0x91,
+        0x47, 0x76, 0x25, 0x14, 0x83, 0xb2, 0xe1, 0xd0, 0xfe, 0xcf, 0x9c, 0xad, 0x3a, 0x0b, 0x58, 0x69,
+        0x04, 0x35, 0x66, 0x57, 0xc0, 0xf1, 0xa2, 0x93, 0xbd, 0x8c, 0xdf, 0xee, 0x79, 0x48, 0x1b, 0x2a,
+        0xc1, 0xf0, 0xa3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1a, 0x2b, 0xbc, 0x8d, 0xde, 0xef,
+        0x82, 0xb3, 0xe0, 0xd1, 0x46, 0x77, 0x24, 0x15, 0x3b, 0x0a, 0x59, 0x68, 0xff, 0xce, 0x9d, 0xac,
+};
+
+static uint8_t const crc8_table_07[256] = {
+        0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15, 0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
+        0x70, 0x77, 0x7e, 0x79, 0x6c, 0x6b, 0x62, 0x65, 0x48, 0x4f, 0x46, 0x41, 0x54, 0x53, 0x5a, 0x5d,
+        0xe0, 0xe7, 0xee, 0xe9, 0xfc, 0xfb, 0xf2, 0xf5, 0xd8, 0xdf, 0xd6, 0xd1, 0xc4, 0xc3, 0xca, 0xcd,
+        0x90, 0x97, 0x9e, 0x99, 0x8c, 0x8b, 0x82, 0x85, 0xa8, 0xaf, 0xa6, 0xa1, 0xb4, 0xb3, 0xba, 0xbd,
+        0xc7, 0xc0, 0xc9, 0xce, 0xdb, 0xdc, 0xd5, 0xd2, 0xff, 0xf8, 0xf1, 0xf6, 0xe3, 0xe4, 0xed, 0xea,
+        0xb7, 0xb0, 0xb9, 0xbe, 0xab, 0xac, 0xa5, 0xa2, 0x8f, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9d, 0x9a,
+        0x27, 0x20, 0x29, 0x2e, 0x3b, 0x3c, 0x35, 0x32, 0x1f, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0d, 0x0a,
+        0x57, 0x50, 0x59, 0x5e, 0x4b, 0x4c, 0x45, 0x42, 0x6f, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7d, 0x7a,
+        0x89, 0x8e, 0x87, 0x80, 0x95, 0x92, 0x9b, 0x9c, 0xb1, 0xb6, 0xbf, 0xb8, 0xad, 0xaa, 0xa3, 0xa4,
+        0xf9, 0xfe, 0xf7, 0xf0, 0xe5, 0xe2, 0xeb, 0xec, 0xc1, 0xc6, 0xcf, 0xc8, 0xdd, 0xda, 0xd3, 0xd4,
+        0x69, 0x6e, 0x67, 0x60, 0x75, 0x72, 0x7b, 0x7c, 0x51, 0x56, 0x5f, 0x58, 0x4d, 0x4a, 0x43, 0x44,
+        0x19, 0x1e, 0x17, 0x10, 0x05, 0x02, 0x0b, 0x0c, 0x21, 0x26, 0x2f, 0x28, 0x3d, 0x3a, 0x33, 0x34,
+        0x4e, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5c, 0x5b, 0x76, 0x71, 0x78, 0x7f, 0x6a, 0x6d, 0x64, 0x63,
+        0x3e, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2c, 0x2b, 0x06, 0x01, 0x08, 0x0f, 0x1a, 0x1d, 0x14, 0x13,
+        0xae, 0xa9, 0xa0, 0xa7, 0xb2, 0xb5, 0xbc, 0xbb, 0x96, 0x91, 0x98, 0x9f, 0x8a, 0x8d, 0x84, 0x83,
+        0xde, 0xd9, 0xd0, 0xd7, 0xc2, 0xc5, 0xcc, 0xcb, 0xe6, 0xe1, 0xe8, 0xef, 0xfa, 0xfd, 0xf4, 0xf3,
+};
+
+static uint8_t const crc8le_table_31[256] = {
+        0x00, 0x5e, 0xbc, 0xe2, 0x61, 0x3f, 0xdd, 0x83, 0xc2, 0x9c, 0x7e, 0x20, 0xa3, 0xfd, 0x1f, 0x41,
+        0x9d, 0xc3, 0x21, 0x7f, 0xfc, 0xa2, 0x40, 0x1e, 0x5f, 0x01, 0xe3, 0xbd, 0x3e, 0x60, 0x82, 0xdc,
+        0x23, 0x7d, 0x9f, 0xc1, 0x42, 0x1c, 0xfe, 0xa0, 0xe1, 0xbf, 0x5d, 0x03, 0x80, 0xde, 0x3c, 0x62,
+        0xbe, 0xe0, 0x02, 0x5c, 0xdf, 0x81, 0x63, 0x3d, 0x7c, 0x22, 0xc0, 0x9e, 0x1d, 0x43, 0xa1, 0xff,
+        0x46, 0x18, 0xfa, 0xa4, 0x27, 0x79, 0x9b, 0xc5, 0x84, 0xda, 0x38, 0x66, 0xe5, 0xbb, 0x59, 0x07,
+        0xdb, 0x85, 0x67, 0x39, 0xba, 0xe4, 0x06, 0x58, 0x19, 0x47, 0xa5, 0xfb, 0x78, 0x26, 0xc4, 0x9a,
+        0x65, 0x3b, 0xd9, 0x87, 0x04, 0x5a, 0xb8, 0xe6, 0xa7, 0xf9, 0x1b, 0x45, 0xc6, 0x98, 0x7a, 0x24,
+        0xf8, 0xa6, 0x44, 0x1a, 0x99, 0xc7, 0x25, 0x7b, 0x3a, 0x64, 0x86, 0xd8, 0x5b, 0x05, 0xe7, 0xb9,
+        0x8c, 0xd2, 0x30, 0x6e, 0xed, 0xb3, 0x51, 0x0f, 0x4e, 0x10, 0xf2, 0xac, 0x2f, 0x71, 0x93, 0xcd,
+        0x11, 0x4f, 0xad, 0xf3, 0x70, 0x2e, 0xcc, 0x92, 0xd3, 0x8d, 0x6f, 0x31, 0xb2, 0xec, 0x0e, 0x50,
+        0xaf, 0xf1, 0x13, 0x4d, 0xce, 0x90, 0x72, 0x2c, 0x6d, 0x33, 0xd1, 0x8f, 0x0c, 0x52, 0xb0, 0xee,
+        0x32, 0x6c, 0x8e, 0xd0, 0x53, 0x0d, 0xef, 0xb1, 0xf0, 0xae, 0x4c, 0x12, 0x91, 0xcf, 0x2d, 0x73,
+        0xca, 0x94, 0x76, 0x28, 0xab, 0xf5, 0x17, 0x49, 0x08, 0x56, 0xb4, 0xea, 0x69, 0x37, 0xd5, 0x8b,
+        0x57, 0x09, 0xeb, 0xb5, 0x36, 0x68, 0x8a, 0xd4, 0x95, 0xcb, 0x29, 0x77, 0xf4, 0xaa, 0x48, 0x16,
+        0xe9, 0xb7, 0x55, 0x0b, 0x88, 0xd6, 0x34, 0x6a, 0x2b, 0x75, 0x97, 0xc9, 0x4a, 0x14, 0xf6, 0xa8,
+        0x74, 0x2a, 0xc8, 0x96, 0x15, 0x4b, 0xa9, 0xf7, 0xb6, 0xe8, 0x0a, 0x54, 0xd7, 0x89, 0x6b, 0x35,
+};
+
+static uint8_t const crc8le_table_07[256] = {
+        0x00, 0x91, 0xe3, 0x72, 0x07, 0x96, 0xe4, 0x75, 0x0e, 0x9f, 0xed, 0x7c, 0x09, 0x98, 0xea, 0x7b,
+        0x1c, 0x8d, 0xff, 0x6e, 0x1b, 0x8a, 0xf8, 0x69, 0x12, 0x83, 0xf1, 0x60, 0x15, 0x84, 0xf6, 0x67,
+        0x38, 0xa9, 0xdb, 0x4a, 0x3f, 0xae, 0xdc, 0x4d, 0x36, 0xa7, 0xd5, 0x44, 0x31, 0xa0, 0xd2, 0x43,
+        0x24, 0xb5, 0xc7, 0x56, 0x23, 0xb2, 0xc0, 0x51, 0x2a, 0xbb, 0xc9, 0x58, 0x2d, 0xbc, 0xce, 0x5f,
+        0x70, 0xe1, 0x93, 0x02, 0x77, 0xe6, 0x94, 0x05, 0x7e, 0xef, 0x9d, 0x0c, 0x79, 0xe8, 0x9a, 0x0b,
+        0x6c, 0xfd, 0x8f, 0x1e, 0x6b, 0xfa, 0x88, 0x19, 0x62, 0xf3, 0x81, 0x10, 0x65, 0xf4, 0x86, 0x17,
+        0x48, 0xd9, 0xab, 0x3a, 0x4f, 0xde, 0xac, 0x3d, 0x46, 0xd7, 0xa5, 0x34, 0x41, 0xd0, 0xa2, 0x33,
+        0x54, 0xc5, 0xb7, 0x26, 0x53, 0xc2, 0xb0, 0x21, 0x5a, 0xcb, 0xb9, 0x28, 0x5d, 0xcc, 0xbe, 0x2f,
+        0xe0, 0x71, 0x03, 0x92, 0xe7, 0x76, 0x04, 0x95, 0xee, 0x7f, 0x0d, 0x9c, 0xe9, 0x78, 0x0a, 0x9b,
+        0xfc, 0x6d, 0x1f, 0x8e, 0xfb, 0x6a, 0x18, 0x89, 0xf2, 0x63, 0x11, 0x80, 0xf5, 0x64, 0x16, 0x87,
+        0xd8, 0x49, 0x3b, 0xaa, 0xdf, 0x4e, 0x3c, 0xad, 0xd6, 0x47, 0x35, 0xa4, 0xd1, 0x40, 0x32, 0xa3,
+        0xc4, 0x55, 0x27, 0xb6, 0xc3, 0x52, 0x20, 0xb1, 0xca, 0x5b, 0x29, 0xb8, 0xcd, 0x5c, 0x2e, 0xbf,
+        0x90, 0x01, 0x73, 0xe2, 0x97, 0x06, 0x74, 0xe5, 0x9e, 0x0f, 0x7d, 0xec, 0x99, 0x08, 0x7a, 0xeb,
+        0x8c, 0x1d, 0x6f, 0xfe, 0x8b, 0x1a, 0x68, 0xf9, 0x82, 0x13, 0x61, 0xf0, 0x85, 0x14, 0x66, 0xf7,
+        0xa8, 0x39, 0x4b, 0xda, 0xaf, 0x3e, 0x4c, 0xdd, 0xa6, 0x37, 0x45, 0xd4, 0xa1, 0x30, 0x42, 0xd3,
+        0xb4, 0x25, 0x57, 0xc6, 0xb3, 0x22, 0x50, 0xc1, 0xba, 0x2b, 0x59, 0xc8, 0xbd, 0x2c, 0x5e, 0xcf,
+};
+
+static uint16_t const crc16lsb_table_a001[256] = {
+        0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241,
+        0xc601, 0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440,
+        0xcc01, 0x0cc0, 0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40,
+        0x0a00, 0xcac1, 0xcb81, 0x0b40, 0xc901, 0x09c0, 0x0880, 0xc841,
+        0xd801, 0x18c0, 0x1980, 0xd941, 0x1b00, 0xdbc1, 0xda81, 0x1a40,
+        0x1e00, 0xdec1, 0xdf81, 0x1f40, 0xdd01, 0x1dc0, 0x1c80, 0xdc41,
+        0x1400, 0xd4c1, 0xd581, 0x1540, 0xd701, 0x17c0, 0x1680, 0xd641,
+        0xd201, 0x12c0, 0x1380, 0xd341, 0x1100, 0xd1c1, 0xd081, 0x1040,
+        0xf001, 0x30c0, 0x3180, 0xf141, 0x3300, 0xf3c1, 0xf281, 0x3240,
+        0x3600, 0xf6c1, 0xf781, 0x3740, 0xf501, 0x35c0, 0x3480, 0xf441,
+        0x3c00, 0xfcc1, 0xfd81, 0x3d40, 0xff01, 0x3fc0, 0x3e80, 0xfe41,
+        0xfa01, 0x3ac0, 0x3b80, 0xfb41, 0x3900, 0xf9c1, 0xf881, 0x3840,
+        0x2800, 0xe8c1, 0xe981, 0x2940, 0xeb01, 0x2bc0, 0x2a80, 0xea41,
+        0xee01, 0x2ec0, 0x2f80, 0xef41, 0x2d00, 0xedc1, 0xec81, 0x2c40,
+        0xe401, 0x24c0, 0x2580, 0xe541, 0x2700, 0xe7c1, 0xe681, 0x2640,
+        0x2200, 0xe2c1, 0xe381, 0x2340, 0xe101, 0x21c0, 0x2080, 0xe041,
+        0xa001, 0x60c0, 0x6180, 0xa141, 0x6300, 0xa3c1, 0xa281, 0x6240,
+        0x6600, 0xa6c1, 0xa781, 0x6740, 0xa501, 0x65c0, 0x6480, 0xa441,
+        0x6c00, 0xacc1, 0xad81, 0x6d40, 0xaf01, 0x6fc0, 0x6e80, 0xae41,
+        0xaa01, 0x6ac0, 0x6b80, 0xab41, 0x6900, 0xa9c1, 0xa881, 0x6840,
+        0x7800, 0xb8c1, 0xb981, 0x7940, 0xbb01, 0x7bc0, 0x7a80, 0xba41,
+        0xbe01, 0x7ec0, 0x7f80, 0xbf41, 0x7d00, 0xbdc1, 0xbc81, 0x7c40,
+        0xb401, 0x74c0, 0x7580, 0xb541, 0x7700, 0xb7c1, 0xb681, 0x7640,
+        0x7200, 0xb2c1, 0xb381, 0x7340, 0xb101, 0x71c0, 0x7080, 0xb041,
+        0x5000, 0x90c1, 0x9181, 0x5140, 0x9301, 0x53c0, 0x5280, 0x9241,
+        0x9601, 0x56c0, 0x5780, 0x9741, 0x5500, 0x95c1, 0x9481, 0x5440,
+        0x9c01, 0x5cc0, 0x5d80, 0x9d41, 0x5f00, 0x9fc1, 0x9e81, 0x5e40,
+        0x5a00, 0x9ac1, 0x9b81, 0x5b40, 0x9901, 0x59c0, 0x5880, 0x9841,
+        0x8801, 0x48c0, 0x4980, 0x8941, 0x4b00, 0x8bc1, 0x8a81, 0x4a40,
+        0x4e00, 0x8ec1, 0x8f81, 0x4f40, 0x8d01, 0x4dc0, 0x4c80, 0x8c41,
+        0x4400, 0x84c1, 0x8581, 0x4540, 0x8701, 0x47c0, 0x4680, 0x8641,
+        0x8201, 0x42c0, 0x4380, 0x8341, 0x4100, 0x81c1, 0x8081, 0x4040,
+};
+
+static uint16_t const crc16lsb_table_8408[256] = {
+        0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf,
+        0x8c48, 0x9dc1, 0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7,
+        0x1081, 0x0108, 0x3393, 0x221a, 0x56a5, 0x472c, 0x75b7, 0x643e,
+        0x9cc9, 0x8d40, 0xbfdb, 0xae52, 0xdaed, 0xcb64, 0xf9ff, 0xe876,
+        0x2102, 0x308b, 0x0210, 0x1399, 0x6726, 0x76af, 0x4434, 0x55bd,
+        0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e, 0xfae7, 0xc87c, 0xd9f5,
+        0x3183, 0x200a, 0x1291, 0x0318, 0x77a7, 0x662e, 0x54b5, 0x453c,
+        0xbdcb, 0xac42, 0x9ed9, 0x8f50, 0xfbef, 0xea66, 0xd8fd, 0xc974,
+        0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9, 0x2732, 0x36bb,
+        0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3,
+        0x5285, 0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a,
+        0xdecd, 0xcf44, 0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72,
+        0x6306, 0x728f, 0x4014, 0x519d, 0x2522, 0x34ab, 0x0630, 0x17b9,
+        0xef4e, 0xfec7, 0xcc5c, 0xddd5, 0xa96a, 0xb8e3, 0x8a78, 0x9bf1,
+        0x7387, 0x620e, 0x5095, 0x411c, 0x35a3, 0x242a, 0x16b1, 0x0738,
+        0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862, 0x9af9, 0x8b70,
+        0x8408, 0x9581, 0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e, 0xf0b7,
+        0x0840, 0x19c9, 0x2b52, 0x3adb, 0x4e64, 0x5fed, 0x6d76, 0x7cff,
+        0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324, 0xf1bf, 0xe036,
+        0x18c1, 0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e,
+        0xa50a, 0xb483, 0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5,
+        0x2942, 0x38cb, 0x0a50, 0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd,
+        0xb58b, 0xa402, 0x9699, 0x8710, 0xf3af, 0xe226, 0xd0bd, 0xc134,
+        0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7, 0x6e6e, 0x5cf5, 0x4d7c,
+        0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1, 0xa33a, 0xb2b3,
+        0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72, 0x3efb,
+        0xd68d, 0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232,
+        0x5ac5, 0x4b4c, 0x79d7, 0x685e, 0x1ce1, 0x0d68, 0x3ff3, 0x2e7a,
+        0xe70e, 0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3, 0x8238, 0x93b1,
+        0x6b46, 0x7acf, 0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9,
+        0xf78f, 0xe606, 0xd49d, 0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330,
+        0x7bc7, 0x6a4e, 0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78,
+};
+
+static uint16_t const crc16_table_1021[256] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+        0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+        0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
+        0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,
+        0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
+        0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
+        0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
+        0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,
+        0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
+        0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
+        0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
+        0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
+        0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
+        0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
+        0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
+        0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,
+        0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
+        0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
+        0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
+        0x02b1, 0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,
+        0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
+        0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+        0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
+        0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
+        0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
+        0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
+        0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
+        0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
+        0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
+        0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
+        0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
+        0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,
+};
+
+static uint16_t const crc16_table_8005[256] = {
+        0x0000, 0x8005, 0x800f, 0x000a, 0x801b, 0x001e, 0x0014, 0x8011,
+        0x8033, 0x0036, 0x003c, 0x8039, 0x0028, 0x802d, 0x8027, 0x0022,
+        0x8063, 0x0066, 0x006c, 0x8069, 0x0078, 0x807d, 0x8077, 0x0072,
+        0x0050, 0x8055, 0x805f, 0x005a, 0x804b, 0x004e, 0x0044, 0x8041,
+        0x80c3, 0x00c6, 0x00cc, 0x80c9, 0x00d8, 0x80dd, 0x80d7, 0x00d2,
+        0x00f0, 0x80f5, 0x80ff, 0x00fa, 0x80eb, 0x00ee, 0x00e4, 0x80e1,
+        0x00a0, 0x80a5, 0x80af, 0x00aa, 0x80bb, 0x00be, 0x00b4, 0x80b1,
+        0x8093, 0x0096, 0x009c, 0x8099, 0x0088, 0x808d, 0x8087, 0x0082,
+        0x8183, 0x0186, 0x018c, 0x8189, 0x0198, 0x819d, 0x8197, 0x0192,
+        0x01b0, 0x81b5, 0x81bf, 0x01ba, 0x81ab, 0x01ae, 0x01a4, 0x81a1,
+        0x01e0, 0x81e5, 0x81ef, 0x01ea, 0x81fb, 0x01fe, 0x01f4, 0x81f1,
+        0x81d3, 0x01d6, 0x01dc, 0x81d9, 0x01c8, 0x81cd, 0x81c7, 0x01c2,
+        0x0140, 0x8145, 0x814f, 0x014a, 0x815b, 0x015e, 0x0154, 0x8151,
+        0x8173, 0x0176, 0x017c, 0x8179, 0x0168, 0x816d, 0x8167, 0x0162,
+        0x8123, 0x0126, 0x012c, 0x8129, 0x0138, 0x813d, 0x8137, 0x0132,
+        0x0110, 0x8115, 0x811f, 0x011a, 0x810b, 0x010e, 0x0104, 0x8101,
+        0x8303, 0x0306, 0x030c, 0x8309, 0x0318, 0x831d, 0x8317, 0x0312,
+        0x0330, 0x8335, 0x833f, 0x033a, 0x832b, 0x032e, 0x0324, 0x8321,
+        0x0360, 0x8365, 0x836f, 0x036a, 0x837b, 0x037e, 0x0374, 0x8371,
+        0x8353, 0x0356, 0x035c, 0x8359, 0x0348, 0x834d, 0x8347, 0x0342,
+        0x03c0, 0x83c5, 0x83cf, 0x03ca, 0x83db, 0x03de, 0x03d4, 0x83d1,
+        0x83f3, 0x03f6, 0x03fc, 0x83f9, 0x03e8, 0x83ed, 0x83e7, 0x03e2,
+        0x83a3, 0x03a6, 0x03ac, 0x83a9, 0x03b8, 0x83bd, 0x83b7, 0x03b2,
+        0x0390, 0x8395, 0x839f, 0x039a, 0x838b, 0x038e, 0x0384, 0x8381,
+        0x0280, 0x8285, 0x828f, 0x028a, 0x829b, 0x029e, 0x0294, 0x8291,
+        0x82b3, 0x02b6, 0x02bc, 0x82b9, 0x02a8, 0x82ad, 0x82a7, 0x02a2,
+        0x82e3, 0x02e6, 0x02ec, 0x82e9, 0x02f8, 0x82fd, 0x82f7, 0x02f2,
+        0x02d0, 0x82d5, 0x82df, 0x02da, 0x82cb, 0x02ce, 0x02c4, 0x82c1,
+        0x8243, 0x0246, 0x024c, 0x8249, 0x0258, 0x825d, 0x8257, 0x0252,
+        0x0270, 0x8275, 0x827f, 0x027a, 0x826b, 0x026e, 0x0264, 0x8261,
+        0x0220, 0x8225, 0x822f, 0x022a, 0x823b, 0x023e, 0x0234, 0x8231,
+        0x8213, 0x0216, 0x021c, 0x8219, 0x0208, 0x820d, 0x8207, 0x0202,
+};
+
+static uint8_t const *crc8_table(uint8_t polynomial)
+{
+    switch (polynomial) {
+    case 0x31: return crc8_table_31;
+    case 0x07: return crc8_table_07;
+    default: return NULL;
+    }
+}
+
+static uint8_t const *crc8le_table(uint8_t polynomial)
+{
+    switch (polynomial) {
+    case 0x31: return crc8le_table_31;
+    case 0x07: return crc8le_table_07;
+    default: return NULL;
+    }
+}
+
+static uint16_t const *crc16lsb_table(uint16_t polynomial)
+{
+    switch (polynomial) {
+    case 0xa001: return crc16lsb_table_a001;
+    case 0x8408: return crc16lsb_table_8408;
+    default: return NULL;
+    }
+}
+
+static uint16_t const *crc16_table(uint16_t polynomial)
+{
+    switch (polynomial) {
+    case 0x1021: return crc16_table_1021;
+    case 0x8005: return crc16_table_8005;
+    default: return NULL;
+    }
+}
+
+static uint8_t crc8_bitwise(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uint8_t init)
 {
     uint8_t remainder = init;
     unsigned byte, bit;
@@ -243,7 +590,20 @@ uint8_t crc8(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uint8
     return remainder;
 }
 
-uint8_t crc8le(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uint8_t init)
+uint8_t crc8(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uint8_t init)
+{
+    uint8_t const *table = crc8_table(polynomial);
+    if (!table)
+        return crc8_bitwise(message, nBytes, polynomial, init);
+
+    uint8_t remainder = init;
+    for (unsigned byte = 0; byte < nBytes; ++byte) {
+        remainder = table[remainder ^ message[byte]];
+    }
+    return remainder;
+}
+
+static uint8_t crc8le_bitwise(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uint8_t init)
 {
     uint8_t remainder = reverse8(init);
     unsigned byte, bit;
@@ -262,7 +622,20 @@ uint8_t crc8le(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uin
     return remainder;
 }
 
-uint16_t crc16lsb(uint8_t const message[], unsigned nBytes, uint16_t polynomial, uint16_t init)
+uint8_t crc8le(uint8_t const message[], unsigned nBytes, uint8_t polynomial, uint8_t init)
+{
+    uint8_t const *table = crc8le_table(polynomial);
+    if (!table)
+        return crc8le_bitwise(message, nBytes, polynomial, init);
+
+    uint8_t remainder = reverse8(init);
+    for (unsigned byte = 0; byte < nBytes; ++byte) {
+        remainder = table[remainder ^ message[byte]];
+    }
+    return remainder;
+}
+
+static uint16_t crc16lsb_bitwise(uint8_t const message[], unsigned nBytes, uint16_t polynomial, uint16_t init)
 {
     uint16_t remainder = init;
     unsigned byte, bit;
@@ -281,7 +654,20 @@ uint16_t crc16lsb(uint8_t const message[], unsigned nBytes, uint16_t polynomial,
     return remainder;
 }
 
-uint16_t crc16(uint8_t const message[], unsigned nBytes, uint16_t polynomial, uint16_t init)
+uint16_t crc16lsb(uint8_t const message[], unsigned nBytes, uint16_t polynomial, uint16_t init)
+{
+    uint16_t const *table = crc16lsb_table(polynomial);
+    if (!table)
+        return crc16lsb_bitwise(message, nBytes, polynomial, init);
+
+    uint16_t remainder = init;
+    for (unsigned byte = 0; byte < nBytes; ++byte) {
+        remainder = (remainder >> 8) ^ table[(remainder ^ message[byte]) & 0xff];
+    }
+    return remainder;
+}
+
+static uint16_t crc16_bitwise(uint8_t const message[], unsigned nBytes, uint16_t polynomial, uint16_t init)
 {
     uint16_t remainder = init;
     unsigned byte, bit;
@@ -300,7 +686,144 @@ uint16_t crc16(uint8_t const message[], unsigned nBytes, uint16_t polynomial, ui
     return remainder;
 }
 
-uint8_t lfsr_digest8(uint8_t const message[], unsigned bytes, uint8_t gen, uint8_t key)
+uint16_t crc16(uint8_t const message[], unsigned nBytes, uint16_t polynomial, uint16_t init)
+{
+    uint16_t const *table = crc16_table(polynomial);
+    if (!table)
+        return crc16_bitwise(message, nBytes, polynomial, init);
+
+    uint16_t remainder = init;
+    for (unsigned byte = 0; byte < nBytes; ++byte) {
+        remainder = (uint16_t)(remainder << 8) ^ table[(remainder >> 8) ^ message[byte]];
+    }
+    return remainder;
+}
+
+// The digests are linear: with the key stepping as multiplication by x in
+// GF(2)[x]/(x^n + gen) the sum is the key times the message polynomial.
+// The message is reduced a byte at a time with a table of x^8 times each
+// byte value, which only depends on gen, then multiplied by the key with
+// the bit-serial loop over the one byte (or word) left.
+// Tables for the gens decoders use, const tables stay in flash on the ESP32.
+
+static uint8_t const lfsr8_table_98[256] = {
+        0x00, 0x34, 0x68, 0x5c, 0xd0, 0xe4, 0xb8, 0x8c, 0x91, 0xa5, 0xf9, 0xcd, 0x41, 0x75, 0x29, 0x1d,
+        0x13, 0x27, 0x7b, 0x4f, 0xc3, 0xf7, 0xab, 0x9f, 0x82, 0xb6, 0xea, 0xde, 0x52, 0x66, 0x3a, 0x0e,
+        0x26, 0x12, 0x4e, 0x7a, 0xf6, 0xc2, 0x9e, 0xaa, 0xb7, 0x83, 0xdf, 0xeb, 0x67, 0x53, 0x0f, 0x3b,
+        0x35, 0x01, 0x5d, 0x69, 0xe5, 0xd1, 0x8d, 0xb9, 0xa4, 0x90, 0xcc, 0xf8, 0x74, 0x40, 0x1c, 0x28,
+        0x4c, 0x78, 0x24, 0x10, 0x9c, 0xa8, 0xf4, 0xc0, 0xdd, 0xe9, 0xb5, 0x81, 0x0d, 0x39, 0x65, 0x51,
+        0x5f, 0x6b, 0x37, 0x03, 0x8f, 0xbb, 0xe7, 0xd3, 0xce, 0xfa, 0xa6, 0x92, 0x1e, 0x2a, 0x76, 0x42,
+        0x6a, 0x5e, 0x02, 0x36, 0xba, 0x8e, 0xd2, 0xe6, 0xfb, 0xcf, 0x93, 0xa7, 0x2b, 0x1f, 0x43, 0x77,
+        0x79, 0x4d, 0x11, 0x25, 0xa9, 0x9d, 0xc1, 0xf5, 0xe8, 0xdc, 0x80, 0xb4, 0x38, 0x0c, 0x50, 0x64,
+        0x98, 0xac, 0xf0, 0xc4, 0x48, 0x7c, 0x20, 0x14, 0x09, 0x3d, 0x61, 0x55, 0xd9, 0xed, 0xb1, 0x85,
+        0x8b, 0xbf, 0xe3, 0xd7, 0x5b, 0x6f, 0x33, 0x07, 0x1a, 0x2e, 0x72, 0x46, 0xca, 0xfe, 0xa2, 0x96,
+        0xbe, 0x8a, 0xd6, 0xe2, 0x6e, 0x5a, 0x06, 0x32, 0x2f, 0x1b, 0x47, 0x73, 0xff, 0xcb, 0x97, 0xa3,
+        0xad, 0x99, 0xc5, 0xf1, 0x7d, 0x49, 0x15, 0x21, 0x3c, 0x08, 0x54, 0x60, 0xec, 0xd8, 0x84, 0xb0,
+        0xd4, 0xe0, 0xbc, 0x88, 0x04, 0x30, 0x6c, 0x58, 0x45, 0x71, 0x2d, 0x19, 0x95, 0xa1, 0xfd, 0xc9,
+        0xc7, 0xf3, 0xaf, 0x9b, 0x17, 0x23, 0x7f, 0x4b, 0x56, 0x62, 0x3e, 0x0a, 0x86, 0xb2, 0xee, 0xda,
+        0xf2, 0xc6, 0x9a, 0xae, 0x22, 0x16, 0x4a, 0x7e, 0x63, 0x57, 0x0b, 0x3f, 0xb3, 0x87, 0xdb, 0xef,
+        0xe1, 0xd5, 0x89, 0xbd, 0x31, 0x05, 0x59, 0x6d, 0x70, 0x44, 0x18, 0x2c, 0xa0, 0x94, 0xc8, 0xfc,
+};
+
+static uint8_t const lfsr8_reflect_table_31[256] = {
+        0x00, 0x31, 0x62, 0x53, 0xc4, 0xf5, 0xa6, 0x97, 0xb9, 0x88, 0xdb, 0xea, 0x7d, 0x4c, 0x1f, 0x2e,
+        0x43, 0x72, 0x21, 0x10, 0x87, 0xb6, 0xe5, 0xd4, 0xfa, 0xcb, 0x98, 0xa9, 0x3e, 0x0f, 0x5c, 0x6d,
+        0x86, 0xb7, 0xe4, 0xd5, 0x42, 0x73, 0x20, 0x11, 0x3f, 0x0e, 0x5d, 0x6c, 0xfb, 0xca, 0x99, 0xa8,
+        0xc5, 0xf4, 0xa7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7c, 0x4d, 0x1e, 0x2f, 0xb8, 0x89, 0xda, 0xeb,
+        0x3d, 0x0c, 0x5f, 0x6e, 0xf9, 0xc8, 0x9b, 0xaa, 0x84, 0xb5, 0xe6, 0xd7, 0x40, 0x71, 0x22, 0x13,
+        0x7e, 0x4f, 0x1c, 0x2d, 0xba, 0x8b, 0xd8, 0xe9, 0xc7, 0xf6, 0xa5, 0x94, 0x03, 0x32, 0x61, 0x50,
+        0xbb, 0x8a, 0xd9, 0xe8, 0x7f, 0x4e, 0x1d, 0x2c, 0x02, 0x33, 0x60, 0x51, 0xc6, 0xf7, 0xa4, 0x95,
+        0xf8, 0xc9, 0x9a, 0xab, 0x3c, 0x0d, 0x5e, 0x6f, 0x41, 0x70, 0x23, 0x12, 0x85, 0xb4, 0xe7, 0xd6,
+        0x7a, 0x4b, 0x18, 0x29, 0xbe, 0x8f, 0xdc, 0xed, 0xc3, 0xf2, 0xa1, 0x90, 0x07, 0x36, 0x65, 0x54,
+        0x39, 0x08, 0x5b, 0x6a, 0xfd, 0xcc, 0x9f, 0xae, 0x80, 0xb1, 0xe2, 0xd3, 0x44, 0x75, 0x26, 0x17,
+        0xfc, 0xcd, 0x9e, 0xaf, 0x38, 0x09, 0x5a, 0x6b, 0x45, 0x74, 0x27, 0x16, 0x81, 0xb0, 0xe3, 0xd2,
+        0xbf, 0x8e, 0xdd, 0xec, 0x7b, 0x4a, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xc2, 0xf3, 0xa0, 0x91,
+        0x47, 0x76, 0x25, 0x14, 0x83, 0xb2, 0xe1, 0xd0, 0xfe, 0xcf, 0x9c, 0xad, 0x3a, 0x0b, 0x58, 0x69,
+        0x04, 0x35, 0x66, 0x57, 0xc0, 0xf1, 0xa2, 0x93, 0xbd, 0x8c, 0xdf, 0xee, 0x79, 0x48, 0x1b, 0x2a,
+        0xc1, 0xf0, 0xa3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1a, 0x2b, 0xbc, 0x8d, 0xde, 0xef,
+        0x82, 0xb3, 0xe0, 0xd1, 0x46, 0x77, 0x24, 0x15, 0x3b, 0x0a, 0x59, 0x68, 0xff, 0xce, 0x9d, 0xac,
+};
+
+static uint8_t const lfsr8_reflect_table_51[256] = {
+        0x00, 0x51, 0xa2, 0xf3, 0x15, 0x44, 0xb7, 0xe6, 0x2a, 0x7b, 0x88, 0xd9, 0x3f, 0x6e, 0x9d, 0xcc,
+        0x54, 0x05, 0xf6, 0xa7, 0x41, 0x10, 0xe3, 0xb2, 0x7e, 0x2f, 0xdc, 0x8d, 0x6b, 0x3a, 0xc9, 0x98,
+        0xa8, 0xf9, 0x0a, 0x5b, 0xbd, 0xec, 0x1f, 0x4e, 0x82, 0xd3, 0x20, 0x71, 0x97, 0xc6, 0x35, 0x64,
+        0xfc, 0xad, 0x5e, 0x0f, 0xe9, 0xb8, 0x4b, 0x1a, 0xd6, 0x87, 0x74, 0x25, 0xc3, 0x92, 0x61, 0x30,
+        0x01, 0x50, 0xa3, 0xf2, 0x14, 0x45, 0xb6, 0xe7, 0x2b, 0x7a, 0x89, 0xd8, 0x3e, 0x6f, 0x9c, 0xcd,
+        0x55, 0x04, 0xf7, 0xa6, 0x40, 0x11, 0xe2, 0xb3, 0x7f, 0x2e, 0xdd, 0x8c, 0x6a, 0x3b, 0xc8, 0x99,
+        0xa9, 0xf8, 0x0b, 0x5a, 0xbc, 0xed, 0x1e, 0x4f, 0x83, 0xd2, 0x21, 0x70, 0x96, 0xc7, 0x34, 0x65,
+        0xfd, 0xac, 0x5f, 0x0e, 0xe8, 0xb9, 0x4a, 0x1b, 0xd7, 0x86, 0x75, 0x24, 0xc2, 0x93, 0x60, 0x31,
+        0x02, 0x53, 0xa0, 0xf1, 0x17, 0x46, 0xb5, 0xe4, 0x28, 0x79, 0x8a, 0xdb, 0x3d, 0x6c, 0x9f, 0xce,
+        0x56, 0x07, 0xf4, 0xa5, 0x43, 0x12, 0xe1, 0xb0, 0x7c, 0x2d, 0xde, 0x8f, 0x69, 0x38, 0xcb, 0x9a,
+        0xaa, 0xfb, 0x08, 0x59, 0xbf, 0xee, 0x1d, 0x4c, 0x80, 0xd1, 0x22, 0x73, 0x95, 0xc4, 0x37, 0x66,
+        0xfe, 0xaf, 0x5c, 0x0d, 0xeb, 0xba, 0x49, 0x18, 0xd4, 0x85, 0x76, 0x27, 0xc1, 0x90, 0x63, 0x32,
+        0x03, 0x52, 0xa1, 0xf0, 0x16, 0x47, 0xb4, 0xe5, 0x29, 0x78, 0x8b, 0xda, 0x3c, 0x6d, 0x9e, 0xcf,
+        0x57, 0x06, 0xf5, 0xa4, 0x42, 0x13, 0xe0, 0xb1, 0x7d, 0x2c, 0xdf, 0x8e, 0x68, 0x39, 0xca, 0x9b,
+        0xab, 0xfa, 0x09, 0x58, 0xbe, 0xef, 0x1c, 0x4d, 0x81, 0xd0, 0x23, 0x72, 0x94, 0xc5, 0x36, 0x67,
+        0xff, 0xae, 0x5d, 0x0c, 0xea, 0xbb, 0x48, 0x19, 0xd5, 0x84, 0x77, 0x26, 0xc0, 0x91, 0x62, 0x33,
+};
+
+static uint16_t const lfsr16_table_8810[256] = {
+        0x0000, 0x2314, 0x4628, 0x653c, 0x8c50, 0xaf44, 0xca78, 0xe96c,
+        0x0881, 0x2b95, 0x4ea9, 0x6dbd, 0x84d1, 0xa7c5, 0xc2f9, 0xe1ed,
+        0x1102, 0x3216, 0x572a, 0x743e, 0x9d52, 0xbe46, 0xdb7a, 0xf86e,
+        0x1983, 0x3a97, 0x5fab, 0x7cbf, 0x95d3, 0xb6c7, 0xd3fb, 0xf0ef,
+        0x2204, 0x0110, 0x642c, 0x4738, 0xae54, 0x8d40, 0xe87c, 0xcb68,
+        0x2a85, 0x0991, 0x6cad, 0x4fb9, 0xa6d5, 0x85c1, 0xe0fd, 0xc3e9,
+        0x3306, 0x1012, 0x752e, 0x563a, 0xbf56, 0x9c42, 0xf97e, 0xda6a,
+        0x3b87, 0x1893, 0x7daf, 0x5ebb, 0xb7d7, 0x94c3, 0xf1ff, 0xd2eb,
+        0x4408, 0x671c, 0x0220, 0x2134, 0xc858, 0xeb4c, 0x8e70, 0xad64,
+        0x4c89, 0x6f9d, 0x0aa1, 0x29b5, 0xc0d9, 0xe3cd, 0x86f1, 0xa5e5,
+        0x550a, 0x761e, 0x1322, 0x3036, 0xd95a, 0xfa4e, 0x9f72, 0xbc66,
+        0x5d8b, 0x7e9f, 0x1ba3, 0x38b7, 0xd1db, 0xf2cf, 0x97f3, 0xb4e7,
+        0x660c, 0x4518, 0x2024, 0x0330, 0xea5c, 0xc948, 0xac74, 0x8f60,
+        0x6e8d, 0x4d99, 0x28a5, 0x0bb1, 0xe2dd, 0xc1c9, 0xa4f5, 0x87e1,
+        0x770e, 0x541a, 0x3126, 0x1232, 0xfb5e, 0xd84a, 0xbd76, 0x9e62,
+        0x7f8f, 0x5c9b, 0x39a7, 0x1ab3, 0xf3df, 0xd0cb, 0xb5f7, 0x96e3,
+        0x8810, 0xab04, 0xce38, 0xed2c, 0x0440, 0x2754, 0x4268, 0x617c,
+        0x8091, 0xa385, 0xc6b9, 0xe5ad, 0x0cc1, 0x2fd5, 0x4ae9, 0x69fd,
+        0x9912, 0xba06, 0xdf3a, 0xfc2e, 0x1542, 0x3656, 0x536a, 0x707e,
+        0x9193, 0xb287, 0xd7bb, 0xf4af, 0x1dc3, 0x3ed7, 0x5beb, 0x78ff,
+        0xaa14, 0x8900, 0xec3c, 0xcf28, 0x2644, 0x0550, 0x606c, 0x4378,
+        0xa295, 0x8181, 0xe4bd, 0xc7a9, 0x2ec5, 0x0dd1, 0x68ed, 0x4bf9,
+        0xbb16, 0x9802, 0xfd3e, 0xde2a, 0x3746, 0x1452, 0x716e, 0x527a,
+        0xb397, 0x9083, 0xf5bf, 0xd6ab, 0x3fc7, 0x1cd3, 0x79ef, 0x5afb,
+        0xcc18, 0xef0c, 0x8a30, 0xa924, 0x4048, 0x635c, 0x0660, 0x2574,
+        0xc499, 0xe78d, 0x82b1, 0xa1a5, 0x48c9, 0x6bdd, 0x0ee1, 0x2df5,
+        0xdd1a, 0xfe0e, 0x9b32, 0xb826, 0x514a, 0x725e, 0x1762, 0x3476,
+        0xd59b, 0xf68f, 0x93b3, 0xb0a7, 0x59cb, 0x7adf, 0x1fe3, 0x3cf7,
+        0xee1c, 0xcd08, 0xa834, 0x8b20, 0x624c, 0x4158, 0x2464, 0x0770,
+        0xe69d, 0xc589, 0xa0b5, 0x83a1, 0x6acd, 0x49d9, 0x2ce5, 0x0ff1,
+        0xff1e, 0xdc0a, 0xb936, 0x9a22, 0x734e, 0x505a, 0x3566, 0x1672,
+        0xf79f, 0xd48b, 0xb1b7, 0x92a3, 0x7bcf, 0x58db, 0x3de7, 0x1ef3,
+};
+
+static uint8_t const *lfsr8_table(uint8_t gen)
+{
+    switch (gen) {
+    case 0x98: return lfsr8_table_98;
+    default: return NULL;
+    }
+}
+
+static uint8_t const *lfsr8_reflect_table(uint8_t gen)
+{
+    switch (gen) {
+    case 0x31: return lfsr8_reflect_table_31;
+    case 0x51: return lfsr8_reflect_table_51;
+    default: return NULL;
+    }
+}
+
+static uint16_t const *lfsr16_table(uint16_t gen)
+{
+    switch (gen) {
+    case 0x8810: return lfsr16_table_8810;
+    default: return NULL;
+    }
+}
+
+static uint8_t lfsr_digest8_bitwise(uint8_t const message[], unsigned bytes, uint8_t gen, uint8_t key)
 {
     uint8_t sum = 0;
     for (unsigned k = 0; k < bytes; ++k) {
@@ -322,7 +845,21 @@ uint8_t lfsr_digest8(uint8_t const message[], unsigned bytes, uint8_t gen, uint8
     return sum;
 }
 
-uint8_t lfsr_digest8_reflect(uint8_t const message[], int bytes, uint8_t gen, uint8_t key)
+uint8_t lfsr_digest8(uint8_t const message[], unsigned bytes, uint8_t gen, uint8_t key)
+{
+    uint8_t const *table = lfsr8_table(gen);
+    if (!table)
+        return lfsr_digest8_bitwise(message, bytes, gen, key);
+
+    // first byte takes the lowest powers, reduce from the last byte
+    uint8_t poly = 0;
+    for (unsigned k = bytes; k > 0; --k) {
+        poly = table[poly] ^ message[k - 1];
+    }
+    return lfsr_digest8_bitwise(&poly, 1, gen, key);
+}
+
+static uint8_t lfsr_digest8_reflect_bitwise(uint8_t const message[], int bytes, uint8_t gen, uint8_t key)
 {
     uint8_t sum = 0;
     // Process message from last byte to first byte (reflected)
@@ -347,7 +884,21 @@ uint8_t lfsr_digest8_reflect(uint8_t const message[], int bytes, uint8_t gen, ui
     return sum;
 }
 
-uint16_t lfsr_digest16(uint8_t const message[], unsigned bytes, uint16_t gen, uint16_t key)
+uint8_t lfsr_digest8_reflect(uint8_t const message[], int bytes, uint8_t gen, uint8_t key)
+{
+    uint8_t const *table = lfsr8_reflect_table(gen);
+    if (!table)
+        return lfsr_digest8_reflect_bitwise(message, bytes, gen, key);
+
+    // last byte takes the lowest powers, reduce from the first byte
+    uint8_t poly = 0;
+    for (int k = 0; k < bytes; ++k) {
+        poly = table[poly] ^ message[k];
+    }
+    return lfsr_digest8_reflect_bitwise(&poly, 1, gen, key);
+}
+
+static uint16_t lfsr_digest16_bitwise(uint8_t const message[], unsigned bytes, uint16_t gen, uint16_t key)
 {
     uint16_t sum = 0;
     for (unsigned k = 0; k < bytes; ++k) {
@@ -369,6 +920,21 @@ uint16_t lfsr_digest16(uint8_t const message[], unsigned bytes, uint16_t gen, ui
     return sum;
 }
 
+uint16_t lfsr_digest16(uint8_t const message[], unsigned bytes, uint16_t gen, uint16_t key)
+{
+    uint16_t const *table = lfsr16_table(gen);
+    if (!table)
+        return lfsr_digest16_bitwise(message, bytes, gen, key);
+
+    // first byte takes the lowest powers, reduce from the last byte
+    uint16_t poly = 0;
+    for (unsigned k = bytes; k > 0; --k) {
+        poly = (poly >> 8) ^ table[poly & 0xff] ^ (message[k - 1] << 8);
+    }
+    uint8_t const word[2] = {poly >> 8, poly & 0xff};
+    return lfsr_digest16_bitwise(word, 2, gen, key);
+}
+
 /*
 void lfsr_keys_fwd16(int rounds, uint16_t gen, uint16_t key)
 {
@@ -399,24 +965,149 @@ void lfsr_keys_rwd16(int rounds, uint16_t gen, uint16_t key)
 }
 */
 
-// we could use popcount intrinsic, but don't actually need the performance
+// uses the parity intrinsic where the target has a popcount instruction
 int parity8(uint8_t byte)
 {
+#ifdef BIT_UTIL_HAVE_POPCOUNT
+    return __builtin_parity(byte);
+#else
     byte ^= byte >> 4;
     byte &= 0xf;
     return (0x6996 >> byte) & 1;
+#endif
 }
 
 int parity_bytes(uint8_t const message[], unsigned num_bytes)
+{
+    // the parity of all bytes is the parity of their xor
+    return parity8(xor_bytes(message, num_bytes));
+}
+
+uint8_t xor_bytes(uint8_t const message[], unsigned num_bytes)
+{
+    uint8_t result = 0;
+    unsigned i     = 0;
+    unsigned head  = head_bytes(message, num_bytes);
+    for (; i < head; ++i) {
+        result ^= message[i];
+    }
+    uint32_t lanes = 0;
+    for (; i + 4 <= num_bytes; i += 4) {
+        lanes ^= load_word(&message[i]);
+    }
+    lanes ^= lanes >> 16;
+    lanes ^= lanes >> 8;
+    result ^= (uint8_t)lanes;
+    for (; i < num_bytes; ++i) {
+        result ^= message[i];
+    }
+    return result;
+}
+
+/// Sum of the two 16-bit lanes of a word.
+static inline int add_lanes16(uint32_t w)
+{
+    return (int)((w & 0xffff) + (w >> 16));
+}
+
+int add_bytes(uint8_t const message[], unsigned num_bytes)
+{
+    int result    = 0;
+    unsigned i    = 0;
+    unsigned head = head_bytes(message, num_bytes);
+    for (; i < head; ++i) {
+        result += message[i];
+    }
+    while (i + 4 <= num_bytes) {
+        // sum into 16-bit lanes, each word adds at most 2 * 255 per lane
+        uint32_t lanes = 0;
+        for (unsigned n = 0; n < 128 && i + 4 <= num_bytes; ++n, i += 4) {
+            uint32_t w = load_word(&message[i]);
+            lanes += (w & 0x00ff00ff) + (w >> 8 & 0x00ff00ff);
+        }
+        result += add_lanes16(lanes);
+    }
+    for (; i < num_bytes; ++i) {
+        result += message[i];
+    }
+    return result;
+}
+
+int add_nibbles(uint8_t const message[], unsigned num_bytes)
+{
+    int result    = 0;
+    unsigned i    = 0;
+    unsigned head = head_bytes(message, num_bytes);
+    for (; i < head; ++i) {
+        result += (message[i] >> 4) + (message[i] & 0x0f);
+    }
+    while (i + 4 <= num_bytes) {
+        // sum into 8-bit lanes, each word adds at most 2 * 15 per lane
+        uint32_t lanes = 0;
+        for (unsigned n = 0; n < 8 && i + 4 <= num_bytes; ++n, i += 4) {
+            uint32_t w = load_word(&message[i]);
+            lanes += (w & 0x0f0f0f0f) + (w >> 4 & 0x0f0f0f0f);
+        }
+        result += add_lanes16((lanes & 0x00ff00ff) + (lanes >> 8 & 0x00ff00ff));
+    }
+    for (; i < num_bytes; ++i) {
+        result += (message[i] >> 4) + (message[i] & 0x0f);
+    }
+    return result;
+}
+
+#if defined(_TEST) || defined(_BENCH)
+// Reference byte and bit at a time versions of the helpers, for conformance and comparison.
+
+static uint8_t reverse8_ref(uint8_t x)
+{
+    x = (x & 0xF0) >> 4 | (x & 0x0F) << 4;
+    x = (x & 0xCC) >> 2 | (x & 0x33) << 2;
+    x = (x & 0xAA) >> 1 | (x & 0x55) << 1;
+    return x;
+}
+
+#ifdef _TEST
+static uint32_t reverse32_ref(uint32_t x)
+{
+    uint32_t ret;
+    uint8_t const* xp = (uint8_t*)&x;
+    ret = (uint32_t) reverse8_ref(xp[0]) << 24 | reverse8_ref(xp[1]) << 16 | reverse8_ref(xp[2]) << 8 | reverse8_ref(xp[3]);
+    return ret;
+}
+#endif
+
+static void reflect_bytes_ref(uint8_t message[], unsigned num_bytes)
+{
+    for (unsigned i = 0; i < num_bytes; ++i) {
+        message[i] = reverse8_ref(message[i]);
+    }
+}
+
+static void reflect_nibbles_ref(uint8_t message[], unsigned num_bytes)
+{
+    for (unsigned i = 0; i < num_bytes; ++i) {
+        message[i] = reflect4(message[i]);
+    }
+}
+
+static int parity8_ref(uint8_t byte)
+{
+    byte ^= byte >> 4;
+    byte &= 0xf;
+    return (0x6996 >> byte) & 1;
+}
+
+static int parity_bytes_ref(uint8_t const message[], unsigned num_bytes)
 {
     int result = 0;
     for (unsigned i = 0; i < num_bytes; ++i) {
-        result ^= parity8(message[i]);
+        result ^= parity8_ref(message[i]);
     }
     return result;
 }
 
-uint8_t xor_bytes(uint8_t const message[], unsigned num_bytes)
+static uint8_t xor_bytes_ref(uint8_t const message[], unsigned num_bytes)
 {
     uint8_t result = 0;
     for (unsigned i = 0; i < num_bytes; ++i) {
@@ -425,7 +1116,7 @@ uint8_t xor_bytes(uint8_t const message[], unsigned num_bytes)
     return result;
 }
 
-int add_bytes(uint8_t const message[], unsigned num_bytes)
+static int add_bytes_ref(uint8_t const message[], unsigned num_bytes)
 {
     int result = 0;
     for (unsigned i = 0; i < num_bytes; ++i) {
@@ -434,7 +1125,7 @@ int add_bytes(uint8_t const message[], unsigned num_bytes)
     return result;
 }
 
-int add_nibbles(uint8_t const message[], unsigned num_bytes)
+static int add_nibbles_ref(uint8_t const message[], unsigned num_bytes)
 {
     int result = 0;
     for (unsigned i = 0; i < num_bytes; ++i) {
@@ -443,6 +1134,60 @@ int add_nibbles(uint8_t const message[], unsigned num_bytes)
     return result;
 }
 
+static unsigned symbol_match_ref(uint8_t const *message, unsigned offset_bits, unsigned num_bits, uint32_t symbol)
+{
+    unsigned symbol_len = symbol & 0x1f;
+
+    // check required len
+    if (num_bits < symbol_len) {
+        return 0;
+    }
+
+    // match each bit otherwise abort
+    for (unsigned pos = 0; pos < symbol_len; ++pos) {
+        unsigned m_pos = offset_bits + pos;
+        unsigned m_bit = message[m_pos / 8] >> (7 - (m_pos % 8));
+        unsigned s_bit = symbol >> (31 - pos);
+        if ((m_bit & 1) != (s_bit & 1)) {
+            return 0;
+        }
+    }
+
+    return symbol_len;
+}
+
+static unsigned extract_bits_symbols_ref(uint8_t const *message, unsigned offset_bits, unsigned num_bits, uint32_t zero, uint32_t one, uint32_t sync, uint8_t *dst)
+{
+    unsigned zero_len = zero & 0x1f;
+    unsigned one_len  = one & 0x1f;
+    unsigned sync_len = sync & 0x1f;
+
+    unsigned dst_len = 0;
+
+    while (num_bits >= 1) {
+        if (symbol_match_ref(message, offset_bits, num_bits, sync)) {
+            offset_bits += sync_len;
+            num_bits -= sync_len;
+        }
+        else if (symbol_match_ref(message, offset_bits, num_bits, zero)) {
+            offset_bits += zero_len;
+            num_bits -= zero_len;
+            dst_len += 1;
+        }
+        else if (symbol_match_ref(message, offset_bits, num_bits, one)) {
+            offset_bits += one_len;
+            num_bits -= one_len;
+            dst[dst_len / 8] |= 0x80 >> (dst_len % 8);
+            dst_len += 1;
+        }
+        else {
+            break;
+        }
+    }
+    return dst_len;
+}
+#endif /* _TEST || _BENCH */
+
 // Unit testing
 #ifdef _TEST
 #define ASSERT_EQUALS(a, b) \
@@ -488,8 +1233,270 @@ int main(void) {
     ASSERT_EQUALS(bytes[3], 0x02);
     ASSERT_EQUALS(bytes[4], 0x03);
 
+    uint8_t check[] = "123456789";
+
+    fprintf(stderr, "util::crc8(), crc16() et al: catalogue check values\n");
+    ASSERT_EQUALS(crc8(check, 9, 0x07, 0x00), 0xf4);
+    ASSERT_EQUALS(crc8(check, 9, 0x31, 0xff), 0xf7);
+    ASSERT_EQUALS(crc8le(check, 9, 0x31, 0x00), 0xa1);
+    ASSERT_EQUALS(crc8le(check, 9, 0x07, 0xff), 0xd0);
+    ASSERT_EQUALS(crc16lsb(check, 9, 0xa001, 0x0000), 0xbb3d);
+    ASSERT_EQUALS(crc16lsb(check, 9, 0x8408, 0x0000), 0x2189);
+    ASSERT_EQUALS(crc16(check, 9, 0x1021, 0xffff), 0x29b1);
+    ASSERT_EQUALS(crc16(check, 9, 0x1021, 0x0000), 0x31c3);
+    ASSERT_EQUALS(crc16(check, 9, 0x8005, 0x0000), 0xfee8);
+
+    fprintf(stderr, "util::crc8(), crc16() et al: tables match the bit-serial loops\n");
+    uint8_t const polys8[]   = {0x31, 0x07};
+    uint16_t const polys16[] = {0x1021, 0x8005, 0xa001, 0x8408};
+    unsigned mismatches      = 0;
+    uint8_t random[64];
+    for (unsigned i = 0; i < sizeof(random); ++i) {
+        random[i] = (uint8_t)(i * 167 + 13);
+    }
+    for (unsigned len = 0; len <= sizeof(random); ++len) {
+        for (unsigned p = 0; p < 2; ++p) {
+            uint8_t init = (uint8_t)(len * 29);
+            mismatches += crc8(random, len, polys8[p], init) != crc8_bitwise(random, len, polys8[p], init);
+            mismatches += crc8le(random, len, polys8[p], init) != crc8le_bitwise(random, len, polys8[p], init);
+        }
+        for (unsigned p = 0; p < 4; ++p) {
+            uint16_t init = (uint16_t)(len * 2909);
+            mismatches += crc16(random, len, polys16[p], init) != crc16_bitwise(random, len, polys16[p], init);
+            mismatches += crc16lsb(random, len, polys16[p], init) != crc16lsb_bitwise(random, len, polys16[p], init);
+        }
+    }
+    ASSERT_EQUALS(mismatches, 0);
+
+    fprintf(stderr, "util::lfsr_digest8(), lfsr_digest16() et al: tables match the bit-serial loops\n");
+    uint8_t const gens8[] = {0x98, 0x31, 0x51};
+    mismatches            = 0;
+    for (unsigned len = 0; len <= sizeof(random); ++len) {
+        for (unsigned g = 0; g < 3; ++g) {
+            uint8_t key = (uint8_t)(len * 53 + g);
+            mismatches += lfsr_digest8(random, len, gens8[g], key) != lfsr_digest8_bitwise(random, len, gens8[g], key);
+            mismatches += lfsr_digest8_reflect(random, len, gens8[g], key) != lfsr_digest8_reflect_bitwise(random, len, gens8[g], key);
+        }
+        uint16_t key = (uint16_t)(len * 4099 + 7);
+        mismatches += lfsr_digest16(random, len, 0x8810, key) != lfsr_digest16_bitwise(random, len, 0x8810, key);
+    }
+    ASSERT_EQUALS(mismatches, 0);
+
+    fprintf(stderr, "util:: word and table helpers match the reference versions\n");
+    mismatches = 0;
+    for (unsigned x = 0; x < 256; ++x) {
+        mismatches += reverse8(x) != reverse8_ref(x);
+        mismatches += parity8(x) != parity8_ref(x);
+    }
+    for (unsigned n = 0; n < 10000; ++n) {
+        uint32_t x = n * 2654435761u;
+        mismatches += reverse32(x) != reverse32_ref(x);
+    }
+    uint8_t buf[80] __attribute__((aligned(4)));
+    uint8_t buf_a[80], buf_b[80];
+    for (unsigned i = 0; i < sizeof(buf); ++i) {
+        buf[i] = (uint8_t)(i * 197 + 91);
+    }
+    for (unsigned align = 0; align < 4; ++align) {
+        for (unsigned len = 0; len + align <= sizeof(buf); ++len) {
+            uint8_t const *msg = &buf[align];
+            mismatches += parity_bytes(msg, len) != parity_bytes_ref(msg, len);
+            mismatches += xor_bytes(msg, len) != xor_bytes_ref(msg, len);
+            mismatches += add_bytes(msg, len) != add_bytes_ref(msg, len);
+            mismatches += add_nibbles(msg, len) != add_nibbles_ref(msg, len);
+            memcpy(buf_a, buf, sizeof(buf));
+            memcpy(buf_b, buf, sizeof(buf));
+            reflect_bytes(&buf_a[align], len);
+            reflect_bytes_ref(&buf_b[align], len);
+            mismatches += memcmp(buf_a, buf_b, sizeof(buf)) != 0;
+            reflect_nibbles(&buf_a[align], len);
+            reflect_nibbles_ref(&buf_b[align], len);
+            mismatches += memcmp(buf_a, buf_b, sizeof(buf)) != 0;
+        }
+    }
+    // symbols as used by the decoders, MSB aligned with the length in the low bits
+    uint32_t const symbols[][3] = {
+            {0x80000002, 0xc0000002, 0x00000000}, // 10, 11
+            {0x80000003, 0xc0000003, 0xf8000006}, // 100, 110, sync 111110
+            {0x8e000008, 0xe8000008, 0x00000000},
+            {0x55555519, 0xaaaaaa19, 0xfffffc1f},
+    };
+    for (unsigned k = 0; k < 4; ++k) {
+        for (unsigned offset = 0; offset < 64; ++offset) {
+            for (unsigned num_bits = 0; offset + num_bits <= 8 * sizeof(buf); num_bits += 7) {
+                uint8_t dst_a[80] = {0};
+                uint8_t dst_b[80] = {0};
+                mismatches += extract_bits_symbols(buf, offset, num_bits, symbols[k][0], symbols[k][1], symbols[k][2], dst_a)
+                        != extract_bits_symbols_ref(buf, offset, num_bits, symbols[k][0], symbols[k][1], symbols[k][2], dst_b);
+                mismatches += memcmp(dst_a, dst_b, sizeof(dst_a)) != 0;
+            }
+        }
+    }
+    // runs of a symbol, so extraction gets past the first few bits
+    uint8_t const run[] = {0x92, 0x49, 0x24, 0x92, 0x49, 0x24, 0xdb, 0x6d, 0xb6};
+    uint8_t dst_a[9] = {0};
+    uint8_t dst_b[9] = {0};
+    unsigned len_a = extract_bits_symbols(run, 0, 72, 0x80000003, 0xc0000003, 0, dst_a);
+    unsigned len_b = extract_bits_symbols_ref(run, 0, 72, 0x80000003, 0xc0000003, 0, dst_b);
+    ASSERT_EQUALS(len_a, 24);
+    mismatches += len_a != len_b || memcmp(dst_a, dst_b, sizeof(dst_a)) != 0;
+    ASSERT_EQUALS(mismatches, 0);
+
     fprintf(stderr, "util:: test (%u/%u) passed, (%u) failed.\n", passed, passed + failed, failed);
 
     return failed;
 }
 #endif /* _TEST */
+
+// Microbenchmark, build with -D_BENCH
+#ifdef _BENCH
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES() __rdtsc()
+#else
+#define BENCH_CYCLES() 0
+#endif
+
+typedef unsigned (*crc_fn)(uint8_t const message[], unsigned nBytes, unsigned polynomial);
+
+static unsigned crc8_table_fn(uint8_t const message[], unsigned nBytes, unsigned polynomial) { return crc8(message, nBytes, polynomial, 0); }
+static unsigned crc8_bitwise_fn(uint8_t const message[], unsigned nBytes, unsigned polynomial) { return crc8_bitwise(message, nBytes, polynomial, 0); }
+static unsigned crc16_table_fn(uint8_t const message[], unsigned nBytes, unsigned polynomial) { return crc16(message, nBytes, polynomial, 0); }
+static unsigned crc16_bitwise_fn(uint8_t const message[], unsigned nBytes, unsigned polynomial) { return crc16_bitwise(message, nBytes, polynomial, 0); }
+static unsigned crc16lsb_table_fn(uint8_t const message[], unsigned nBytes, unsigned polynomial) { return crc16lsb(message, nBytes, polynomial, 0); }
+static unsigned crc16lsb_bitwise_fn(uint8_t const message[], unsigned nBytes, unsigned polynomial) { return crc16lsb_bitwise(message, nBytes, polynomial, 0); }
+
+/// Time a CRC over typical 12 byte frames, print ns and cycles (x86 TSC only) per byte.
+static void bench_crc(char const *name, crc_fn volatile fn, unsigned polynomial)
+{
+    uint8_t frame[12] = {0};
+    unsigned const rounds = 2000000;
+    unsigned sum = 0;
+    clock_t start = clock();
+    unsigned long long cycles = BENCH_CYCLES();
+    for (unsigned n = 0; n < rounds; ++n) {
+        frame[n % sizeof(frame)] = (uint8_t)n;
+        sum += fn(frame, sizeof(frame), polynomial);
+    }
+    cycles = BENCH_CYCLES() - cycles;
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    double bytes = (double)rounds * sizeof(frame);
+    fprintf(stderr, "%-22s 0x%04x: %6.2f ns/byte %6.2f cycles/byte (%x)\n", name, polynomial, elapsed * 1e9 / bytes, cycles / bytes, sum & 0xf);
+}
+
+typedef unsigned (*digest_fn)(uint8_t const message[], unsigned bytes, unsigned gen, unsigned key);
+
+static unsigned digest8_table_fn(uint8_t const message[], unsigned bytes, unsigned gen, unsigned key) { return lfsr_digest8(message, bytes, gen, key); }
+static unsigned digest8_bitwise_fn(uint8_t const message[], unsigned bytes, unsigned gen, unsigned key) { return lfsr_digest8_bitwise(message, bytes, gen, key); }
+static unsigned digest8_reflect_table_fn(uint8_t const message[], unsigned bytes, unsigned gen, unsigned key) { return lfsr_digest8_reflect(message, bytes, gen, key); }
+static unsigned digest8_reflect_bitwise_fn(uint8_t const message[], unsigned bytes, unsigned gen, unsigned key) { return lfsr_digest8_reflect_bitwise(message, bytes, gen, key); }
+static unsigned digest16_table_fn(uint8_t const message[], unsigned bytes, unsigned gen, unsigned key) { return lfsr_digest16(message, bytes, gen, key); }
+static unsigned digest16_bitwise_fn(uint8_t const message[], unsigned bytes, unsigned gen, unsigned key) { return lfsr_digest16_bitwise(message, bytes, gen, key); }
+
+/// Time the digest of a decoder against the bit-serial loop, print ns per message.
+static void bench_digest(char const *decoder, digest_fn volatile table, digest_fn volatile bitwise, unsigned bytes, unsigned gen, unsigned key)
+{
+    uint8_t msg[32];
+    unsigned const rounds = 1000000;
+    double elapsed[2];
+    unsigned sum[2] = {0};
+    for (int i = 0; i < 2; ++i) {
+        digest_fn fn = i ? table : bitwise;
+        memset(msg, 0, sizeof(msg));
+        clock_t start = clock();
+        for (unsigned n = 0; n < rounds; ++n) {
+            msg[n % bytes] = (uint8_t)n;
+            sum[i] += fn(msg, bytes, gen, key);
+        }
+        elapsed[i] = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }
+    fprintf(stderr, "%-18s %2u bytes: bit-serial %6.1f ns, table %6.1f ns per message%s\n",
+            decoder, bytes, elapsed[0] * 1e9 / rounds, elapsed[1] * 1e9 / rounds, sum[0] == sum[1] ? "" : " MISMATCH");
+}
+
+typedef int (*bytes_fn)(uint8_t message[], unsigned num_bytes);
+
+static int reflect_bytes_fn(uint8_t message[], unsigned num_bytes) { reflect_bytes(message, num_bytes); return message[0]; }
+static int reflect_bytes_ref_fn(uint8_t message[], unsigned num_bytes) { reflect_bytes_ref(message, num_bytes); return message[0]; }
+static int reflect_nibbles_fn(uint8_t message[], unsigned num_bytes) { reflect_nibbles(message, num_bytes); return message[0]; }
+static int reflect_nibbles_ref_fn(uint8_t message[], unsigned num_bytes) { reflect_nibbles_ref(message, num_bytes); return message[0]; }
+static int parity_bytes_fn(uint8_t message[], unsigned num_bytes) { return parity_bytes(message, num_bytes); }
+static int parity_bytes_ref_fn(uint8_t message[], unsigned num_bytes) { return parity_bytes_ref(message, num_bytes); }
+static int xor_bytes_fn(uint8_t message[], unsigned num_bytes) { return xor_bytes(message, num_bytes); }
+static int xor_bytes_ref_fn(uint8_t message[], unsigned num_bytes) { return xor_bytes_ref(message, num_bytes); }
+static int add_bytes_fn(uint8_t message[], unsigned num_bytes) { return add_bytes(message, num_bytes); }
+static int add_bytes_ref_fn(uint8_t message[], unsigned num_bytes) { return add_bytes_ref(message, num_bytes); }
+static int add_nibbles_fn(uint8_t message[], unsigned num_bytes) { return add_nibbles(message, num_bytes); }
+static int add_nibbles_ref_fn(uint8_t message[], unsigned num_bytes) { return add_nibbles_ref(message, num_bytes); }
+static int extract_symbols_fn(uint8_t message[], unsigned num_bytes)
+{
+    uint8_t dst[64] = {0};
+    return extract_bits_symbols(message, 0, num_bytes * 8, 0x80000003, 0xc0000003, 0, dst);
+}
+static int extract_symbols_ref_fn(uint8_t message[], unsigned num_bytes)
+{
+    uint8_t dst[64] = {0};
+    return extract_bits_symbols_ref(message, 0, num_bytes * 8, 0x80000003, 0xc0000003, 0, dst);
+}
+
+/// Time a helper against its reference on messages of a decoder row size, print MB/s.
+static void bench_bytes(char const *name, bytes_fn volatile fn, bytes_fn volatile ref, unsigned num_bytes)
+{
+    uint8_t msg[64] __attribute__((aligned(4)));
+    unsigned const rounds = 2000000;
+    double elapsed[2];
+    for (int i = 0; i < 2; ++i) {
+        bytes_fn f = i ? fn : ref;
+        for (unsigned k = 0; k < sizeof(msg); ++k) {
+            msg[k] = k % 3 == 0 ? 0x92 : k % 3 == 1 ? 0x49 : 0x24; // runs of 100
+        }
+        int sum = 0;
+        clock_t start = clock();
+        for (unsigned n = 0; n < rounds; ++n) {
+            sum += f(msg, num_bytes);
+        }
+        elapsed[i] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        if (sum == 42)
+            fprintf(stderr, " ");
+    }
+    double bytes = (double)rounds * num_bytes / 1e6;
+    fprintf(stderr, "%-20s %2u bytes: reference %7.1f MB/s, optimized %7.1f MB/s\n",
+            name, num_bytes, bytes / elapsed[0], bytes / elapsed[1]);
+}
+
+int main(void)
+{
+    fprintf(stderr, "util:: helper throughput benchmark\n");
+    unsigned const sizes[] = {8, 32};
+    for (unsigned i = 0; i < 2; ++i) {
+        bench_bytes("reflect_bytes", reflect_bytes_fn, reflect_bytes_ref_fn, sizes[i]);
+        bench_bytes("reflect_nibbles", reflect_nibbles_fn, reflect_nibbles_ref_fn, sizes[i]);
+        bench_bytes("parity_bytes", parity_bytes_fn, parity_bytes_ref_fn, sizes[i]);
+        bench_bytes("xor_bytes", xor_bytes_fn, xor_bytes_ref_fn, sizes[i]);
+        bench_bytes("add_bytes", add_bytes_fn, add_bytes_ref_fn, sizes[i]);
+        bench_bytes("add_nibbles", add_nibbles_fn, add_nibbles_ref_fn, sizes[i]);
+        bench_bytes("extract_bits_symbols", extract_symbols_fn, extract_symbols_ref_fn, sizes[i]);
+    }
+
+    fprintf(stderr, "util:: lfsr digest benchmark, parameters of the calling decoders\n");
+    bench_digest("acurite", digest8_table_fn, digest8_bitwise_fn, 3, 0x98, 0xf1);
+    bench_digest("thermopro_tp82xb", digest8_table_fn, digest8_bitwise_fn, 11, 0x98, 0x16);
+    bench_digest("lacrosse_tx141x", digest8_reflect_table_fn, digest8_reflect_bitwise_fn, 4, 0x31, 0xf4);
+    bench_digest("tfa_marbella", digest8_reflect_table_fn, digest8_reflect_bitwise_fn, 7, 0x31, 0x31);
+    bench_digest("thermopro_tp12", digest8_reflect_table_fn, digest8_reflect_bitwise_fn, 4, 0x51, 0x04);
+    bench_digest("maverick_xr30", digest16_table_fn, digest16_bitwise_fn, 3, 0x8810, 0x0d42);
+    bench_digest("bresser_6in1", digest16_table_fn, digest16_bitwise_fn, 15, 0x8810, 0x5412);
+    bench_digest("bresser_7in1", digest16_table_fn, digest16_bitwise_fn, 23, 0x8810, 0xba95);
+
+    fprintf(stderr, "util:: crc benchmark, 12 byte frames\n");
+    bench_crc("crc8 bit-serial", crc8_bitwise_fn, 0x31);
+    bench_crc("crc8 table", crc8_table_fn, 0x31);
+    bench_crc("crc16 bit-serial", crc16_bitwise_fn, 0x1021);
+    bench_crc("crc16 table", crc16_table_fn, 0x1021);
+    bench_crc("crc16lsb bit-serial", crc16lsb_bitwise_fn, 0xa001);
+    bench_crc("crc16lsb table", crc16lsb_table_fn, 0xa001);
+    return 0;
+}
+#endif /* _BENCH */
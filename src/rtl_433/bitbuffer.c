@@ -10,13 +10,86 @@
 */
 
 #include "bitbuffer.h"
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+/// Rows and columns that may hold nonzero bits, written through the API or directly.
+static void bitbuffer_extent(bitbuffer_t const *bits, unsigned *rows, unsigned *cols)
+{
+    unsigned r = bits->free_row > bits->num_rows ? bits->free_row : bits->num_rows;
+    unsigned c = bits->dirty_cols;
+    for (unsigned row = 0; row < r && c < BITBUF_COLS; ++row) {
+        unsigned row_cols = (bits->bits_per_row[row] + 7) / 8;
+        if (row_cols > c)
+            c = row_cols;
+    }
+    if (bits->dirty_rows > r)
+        r = bits->dirty_rows;
+    *rows = r > BITBUF_ROWS ? BITBUF_ROWS : r;
+    *cols = c > BITBUF_COLS ? BITBUF_COLS : c;
+}
+
 void bitbuffer_clear(bitbuffer_t *bits)
 {
-    memset(bits, 0, sizeof(*bits));
+    unsigned rows, cols;
+    bitbuffer_extent(bits, &rows, &cols);
+
+    memset(bits->bits_per_row, 0, rows * sizeof(bits->bits_per_row[0]));
+    memset(bits->syncs_before_row, 0, rows * sizeof(bits->syncs_before_row[0]));
+    if (cols == BITBUF_COLS) {
+        memset(bits->bb, 0, rows * BITBUF_COLS);
+    }
+    else {
+        for (unsigned row = 0; row < rows; ++row) {
+            memset(bits->bb[row], 0, cols);
+        }
+    }
+    bits->num_rows   = 0;
+    bits->free_row   = 0;
+    bits->dirty_rows = 0;
+    bits->dirty_cols = 0;
+    bits->preambles  = NULL;
+}
+
+void bitbuffer_share_preambles(bitbuffer_t *bits, bitbuffer_preambles_t *preambles)
+{
+    memset(preambles->row_valid, 0, sizeof(preambles->row_valid));
+    bits->preambles = preambles;
+}
+
+void bitbuffer_touch(bitbuffer_t *bits)
+{
+    unsigned rows = bits->free_row > bits->num_rows ? bits->free_row : bits->num_rows;
+    if (rows > bits->dirty_rows)
+        bits->dirty_rows = rows;
+    bits->dirty_cols = BITBUF_COLS;
+    bits->preambles  = NULL;
+}
+
+void bitbuffer_copy(bitbuffer_t *dst, bitbuffer_t const *src)
+{
+    bitbuffer_clear(dst);
+
+    unsigned rows, cols;
+    bitbuffer_extent(src, &rows, &cols);
+
+    dst->num_rows   = src->num_rows;
+    dst->free_row   = src->free_row;
+    dst->dirty_rows = rows;
+    dst->dirty_cols = cols;
+    dst->preambles  = src->preambles;
+    memcpy(dst->bits_per_row, src->bits_per_row, rows * sizeof(src->bits_per_row[0]));
+    memcpy(dst->syncs_before_row, src->syncs_before_row, rows * sizeof(src->syncs_before_row[0]));
+    if (cols == BITBUF_COLS) {
+        memcpy(dst->bb, src->bb, rows * BITBUF_COLS);
+    }
+    else {
+        for (unsigned row = 0; row < rows; ++row) {
+            memcpy(dst->bb[row], src->bb[row], cols);
+        }
+    }
 }
 
 void bitbuffer_add_bit(bitbuffer_t *bits, int bit)
@@ -45,15 +118,22 @@ void bitbuffer_add_bit(bitbuffer_t *bits, int bit)
         }
         if (bits->free_row < BITBUF_ROWS) {
             bits->free_row++;
+            if (bits->free_row > bits->dirty_rows)
+                bits->dirty_rows = bits->free_row;
         }
         else {
             // fprintf(stderr, "%s: Could not add more rows\n", __func__);
             return;
         }
     }
+    if (bit_index == 0 && col_index >= bits->dirty_cols) {
+        // first bit in a new column, a spilled row dirties whole rows
+        bits->dirty_cols = col_index < BITBUF_COLS ? col_index + 1 : BITBUF_COLS;
+    }
     uint8_t *b = bits->bb[bits->num_rows - 1];
     b[col_index] |= (bit << (7 - bit_index));
     bits->bits_per_row[bits->num_rows - 1]++;
+    bits->preambles = NULL;
 
 /*
     // preamble compression
@@ -71,6 +151,39 @@ void bitbuffer_add_bit(bitbuffer_t *bits, int bit)
 */
 }
 
+void bitbuffer_add_bits(bitbuffer_t *bits, uint32_t word, unsigned count)
+{
+    if (bits->num_rows == 0)
+        bits->free_row = bits->num_rows = 1; // Add first row automatically
+
+    unsigned const row_bits = BITBUF_COLS * 8;
+    unsigned pos            = bits->bits_per_row[bits->num_rows - 1];
+    // slow path at a row spill or near the row length limit
+    if ((pos > 0 && pos % row_bits == 0)
+            || pos % row_bits + count > row_bits
+            || pos + count >= UINT16_MAX - 1) {
+        while (count) {
+            bitbuffer_add_bit(bits, (word >> --count) & 1);
+        }
+        return;
+    }
+
+    uint8_t *b = bits->bb[bits->num_rows - 1];
+    bits->bits_per_row[bits->num_rows - 1] = pos + count;
+    bits->preambles = NULL;
+    while (count) {
+        unsigned const bit_index = pos % 8;
+        unsigned const take      = count < 8 - bit_index ? count : 8 - bit_index;
+        count -= take;
+        b[pos / 8] |= ((word >> count) & (0xff >> (8 - take))) << (8 - bit_index - take);
+        pos += take;
+    }
+
+    unsigned const cols = (pos + 7) / 8;
+    if (cols > bits->dirty_cols)
+        bits->dirty_cols = cols < BITBUF_COLS ? cols : BITBUF_COLS;
+}
+
 /// Set the width of the current (last) row by expanding or truncating as needed.
 static void bitbuffer_set_width(bitbuffer_t *bits, uint16_t width)
 {
@@ -96,6 +209,14 @@ static void bitbuffer_set_width(bitbuffer_t *bits, uint16_t width)
     }
 
     bits->bits_per_row[bits->num_rows - 1] = width;
+    bits->preambles = NULL;
+
+    // the free row may move down, later bits may be added into a partial byte
+    unsigned cols = (width + 7) / 8;
+    if (bits->free_row > bits->dirty_rows)
+        bits->dirty_rows = bits->free_row;
+    if (cols > bits->dirty_cols)
+        bits->dirty_cols = cols < BITBUF_COLS ? cols : BITBUF_COLS;
 
     unsigned extra_rows = width == 0 ? 0 : (width - 1) / (BITBUF_COLS * 8);
     bits->free_row = bits->num_rows + extra_rows;
@@ -111,6 +232,9 @@ void bitbuffer_add_row(bitbuffer_t *bits)
     if (bits->free_row < BITBUF_ROWS) {
         bits->free_row++;
         bits->num_rows = bits->free_row;
+        // rows stay marked if a decoder drops them
+        if (bits->free_row > bits->dirty_rows)
+            bits->dirty_rows = bits->free_row;
     }
     else {
         bits->bits_per_row[bits->num_rows - 1] = 0; // Clear last row to handle overflow somewhat gracefully
@@ -128,15 +252,51 @@ void bitbuffer_add_sync(bitbuffer_t *bits)
     bits->syncs_before_row[bits->num_rows - 1]++;
 }
 
+/// Read 4 bytes as a big-endian word (MSB first, like the bits in a row).
+static inline uint32_t read_be32(uint8_t const *p)
+{
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+/// Write a word as 4 big-endian bytes.
+static inline void write_be32(uint8_t *p, uint32_t w)
+{
+    p[0] = (uint8_t)(w >> 24);
+    p[1] = (uint8_t)(w >> 16);
+    p[2] = (uint8_t)(w >> 8);
+    p[3] = (uint8_t)w;
+}
+
+/// Return the 32 bits at (possibly unaligned) bit position pos, MSB first.
+/// Bytes at or beyond byte index end are read as zero.
+static inline uint32_t bitrow_get_word(uint8_t const *bytes, unsigned pos, unsigned end)
+{
+    unsigned const col   = pos >> 3;
+    unsigned const shift = pos & 7;
+    if (col + 5 <= end) {
+        return read_be32(&bytes[col]) << shift | (uint32_t)bytes[col + 4] >> (8 - shift);
+    }
+    uint64_t w = 0;
+    for (unsigned i = 0; i < 5; ++i) {
+        w = w << 8 | (col + i < end ? bytes[col + i] : 0);
+    }
+    return (uint32_t)(w >> (8 - shift));
+}
+
 void bitbuffer_invert(bitbuffer_t *bits)
 {
+    bits->preambles = NULL;
     for (unsigned row = 0; row < bits->num_rows; ++row) {
         if (bits->bits_per_row[row] > 0) {
             uint8_t *b = bits->bb[row];
 
             const unsigned last_col  = (bits->bits_per_row[row] - 1) / 8;
             const unsigned last_bits = ((bits->bits_per_row[row] - 1) % 8) + 1;
-            for (unsigned col = 0; col <= last_col; ++col) {
+            unsigned col = 0;
+            for (; col + 4 <= last_col + 1; col += 4) {
+                write_be32(&b[col], ~read_be32(&b[col])); // Invert a word
+            }
+            for (; col <= last_col; ++col) {
                 b[col] = ~b[col]; // Invert
             }
             b[last_col] ^= 0xFF >> last_bits; // Re-invert unused bits in last byte
@@ -144,42 +304,45 @@ void bitbuffer_invert(bitbuffer_t *bits)
     }
 }
 
+/// NRZI decode a row word at a time, each bit is xor'ed with the previous one
+/// and then with invert (all ones for NRZS, zero for NRZM).
+static void bitrow_nrzi_decode(uint8_t *b, unsigned bit_len, uint32_t invert)
+{
+    const unsigned last_col  = (bit_len - 1) / 8;
+    const unsigned last_bits = ((bit_len - 1) % 8) + 1;
+
+    uint32_t prev = 0;
+    unsigned col  = 0;
+    for (; col + 4 <= last_col + 1; col += 4) {
+        uint32_t word = read_be32(&b[col]);
+        uint32_t mask = prev << 31 | word >> 1;
+        prev          = word & 1;
+        write_be32(&b[col], word ^ mask ^ invert);
+    }
+    for (; col <= last_col; ++col) {
+        uint32_t mask = prev << 7 | b[col] >> 1;
+        prev          = b[col] & 1;
+        b[col]        = (uint8_t)(b[col] ^ mask ^ invert);
+    }
+    b[last_col] &= 0xFF << (8 - last_bits); // Clear unused bits in last byte
+}
+
 void bitbuffer_nrzs_decode(bitbuffer_t *bits)
 {
+    bits->preambles = NULL;
     for (unsigned row = 0; row < bits->num_rows; ++row) {
         if (bits->bits_per_row[row] > 0) {
-            uint8_t *b = bits->bb[row];
-
-            const unsigned last_col  = (bits->bits_per_row[row] - 1) / 8;
-            const unsigned last_bits = ((bits->bits_per_row[row] - 1) % 8) + 1;
-
-            int prev = 0;
-            for (unsigned col = 0; col <= last_col; ++col) {
-                int mask = (prev << 7) | b[col] >> 1;
-                prev     = b[col];
-                b[col]   = b[col] ^ ~mask;
-            }
-            b[last_col] &= 0xFF << (8 - last_bits); // Clear unused bits in last byte
+            bitrow_nrzi_decode(bits->bb[row], bits->bits_per_row[row], 0xffffffff);
         }
     }
 }
 
 void bitbuffer_nrzm_decode(bitbuffer_t *bits)
 {
+    bits->preambles = NULL;
     for (unsigned row = 0; row < bits->num_rows; ++row) {
         if (bits->bits_per_row[row] > 0) {
-            uint8_t *b = bits->bb[row];
-
-            const unsigned last_col  = (bits->bits_per_row[row] - 1) / 8;
-            const unsigned last_bits = ((bits->bits_per_row[row] - 1) % 8) + 1;
-
-            int prev = 0;
-            for (unsigned col = 0; col <= last_col; ++col) {
-                int mask = (prev << 7) | b[col] >> 1;
-                prev     = b[col];
-                b[col]   = b[col] ^ mask;
-            }
-            b[last_col] &= 0xFF << (8 - last_bits); // Clear unused bits in last byte
+            bitrow_nrzi_decode(bits->bb[row], bits->bits_per_row[row], 0);
         }
     }
 }
@@ -200,6 +363,11 @@ void bitbuffer_extract_bytes(bitbuffer_t *bitbuffer, unsigned row,
         uint16_t word;
         pos = pos >> 3; // Convert to bytes
 
+        // Four bytes at a time, reading the same input bytes as below
+        for (; bytes >= 4; bytes -= 4, pos += 4, p += 4) {
+            write_be32(p, read_be32(&bits[pos]) << (8 - shift) | bits[pos + 4] >> shift);
+        }
+
         word = bits[pos];
 
         while (bytes--) {
@@ -219,32 +387,143 @@ static inline uint8_t bit_at(const uint8_t *bytes, unsigned bit)
     return (uint8_t)(bytes[bit >> 3] >> (7 - (bit & 7)) & 1);
 }
 
+/// Search a row of len bits for the first match of a pattern at or after start.
+static unsigned bitrow_search(uint8_t const *bits, unsigned len, unsigned start,
+        const uint8_t *pattern, unsigned pattern_bits_len)
+{
+    if (pattern_bits_len == 0 || start >= len || len - start < pattern_bits_len)
+        return len; // Not found
+
+    unsigned const end       = (len + 7) / 8;
+    unsigned const pat_end   = (pattern_bits_len + 7) / 8;
+    unsigned const head_bits = pattern_bits_len < 32 ? pattern_bits_len : 32;
+    uint32_t const head_mask = 0xffffffff << (32 - head_bits);
+    uint32_t const head      = bitrow_get_word(pattern, 0, pat_end) & head_mask;
+    unsigned const last      = len - pattern_bits_len; // last possible match
+
+    // Load 40 bits per byte and compare the 32 bit windows at its 8 positions,
+    // the rest of longer patterns only on a hit
+    for (unsigned ipos = start; ipos <= last;) {
+        unsigned const col = ipos >> 3;
+        uint64_t const window = (uint64_t)bitrow_get_word(bits, col << 3, end) << 8 | (col + 4 < end ? bits[col + 4] : 0);
+        for (unsigned shift = 8 - (ipos & 7); shift > 0 && ipos <= last; --shift, ++ipos) {
+            if (((uint32_t)(window >> shift) & head_mask) != head)
+                continue;
+            unsigned ppos = 32;
+            for (; ppos < pattern_bits_len; ppos += 32) {
+                unsigned n    = pattern_bits_len - ppos < 32 ? pattern_bits_len - ppos : 32;
+                uint32_t mask = 0xffffffff << (32 - n);
+                if ((bitrow_get_word(bits, ipos + ppos, end) ^ bitrow_get_word(pattern, ppos, pat_end)) & mask)
+                    break;
+            }
+            if (ppos >= pattern_bits_len)
+                return ipos;
+        }
+    }
+
+    // Not found
+    return len;
+}
+
+/// Index of a learned pattern, learning it if there is room, -1 if not cached.
+static int preamble_index(bitbuffer_preambles_t *pre, const uint8_t *pattern, unsigned pattern_bits_len)
+{
+    if (pattern_bits_len < 8 || pattern_bits_len > 32)
+        return -1;
+
+    uint32_t const mask  = 0xffffffff << (32 - pattern_bits_len);
+    uint32_t const value = bitrow_get_word(pattern, 0, (pattern_bits_len + 7) / 8) & mask;
+    for (unsigned k = 0; k < pre->num_patterns; ++k) {
+        if (pre->pattern[k] == value && pre->pattern_bits[k] == pattern_bits_len)
+            return k;
+    }
+    if (pre->num_patterns >= BITBUF_PREAMBLES)
+        return -1;
+
+    unsigned const k    = pre->num_patterns++;
+    pre->pattern[k]      = value;
+    pre->pattern_bits[k] = pattern_bits_len;
+    pre->first_byte[value >> 24] |= 1 << k;
+    memset(pre->row_valid, 0, sizeof(pre->row_valid)); // rows lack the new pattern
+    return k;
+}
+
+/// Find the first match of all learned patterns in a row in one pass.
+static void preambles_match_row(bitbuffer_preambles_t *pre, uint8_t const *bits, unsigned row, unsigned len)
+{
+    unsigned const end = (len + 7) / 8;
+    unsigned pending   = 0;
+    for (unsigned k = 0; k < pre->num_patterns; ++k) {
+        pre->first_match[row][k] = len;
+        if (pre->pattern_bits[k] <= len)
+            pending |= 1 << k;
+    }
+
+    // Patterns starting with the first byte of each 32 bit window are candidates
+    for (unsigned ipos = 0; pending && ipos < len;) {
+        unsigned const col = ipos >> 3;
+        uint64_t const window = (uint64_t)bitrow_get_word(bits, col << 3, end) << 8 | (col + 4 < end ? bits[col + 4] : 0);
+        for (unsigned shift = 8; shift > 0 && ipos < len; --shift, ++ipos) {
+            uint32_t const word = (uint32_t)(window >> shift);
+            unsigned candidates = pre->first_byte[word >> 24] & pending;
+            for (unsigned k = 0; candidates; ++k, candidates >>= 1) {
+                if ((candidates & 1)
+                        && ipos + pre->pattern_bits[k] <= len
+                        && (word & 0xffffffff << (32 - pre->pattern_bits[k])) == pre->pattern[k]) {
+                    pre->first_match[row][k] = ipos;
+                    pending &= ~(1u << k);
+                }
+            }
+        }
+    }
+
+    pre->row_bits[row]  = len;
+    pre->row_valid[row] = 1;
+}
+
 unsigned bitbuffer_search(bitbuffer_t *bitbuffer, unsigned row, unsigned start,
         const uint8_t *pattern, unsigned pattern_bits_len)
 {
     uint8_t *bits = bitbuffer->bb[row];
     unsigned len  = bitbuffer->bits_per_row[row];
-    unsigned ipos = start;
-    unsigned ppos = 0; // cursor on init pattern
 
-    while (ipos < len && ppos < pattern_bits_len) {
-        if (bit_at(bits, ipos) == bit_at(pattern, ppos)) {
-            ppos++;
-            ipos++;
-            if (ppos == pattern_bits_len)
-                return ipos - pattern_bits_len;
-        }
-        else {
-            ipos -= ppos;
-            ipos++;
-            ppos = 0;
+    // attached only while the bitbuffer is unchanged since the slice was shared
+    bitbuffer_preambles_t *pre = bitbuffer->preambles;
+    if (pre && row < BITBUF_ROWS) {
+        int k = preamble_index(pre, pattern, pattern_bits_len);
+        if (k >= 0) {
+            if (!pre->row_valid[row] || pre->row_bits[row] != len)
+                preambles_match_row(pre, bits, row, len);
+            unsigned first = pre->first_match[row][k];
+            if (start <= first)
+                return first;
         }
     }
 
-    // Not found
-    return len;
+    return bitrow_search(bits, len, start, pattern, pattern_bits_len);
 }
 
+/// Manchester pairs of a byte: count of leading valid pairs (high nibble)
+/// and their decoded bits (low nibble, last pair in the lowest bit).
+static uint8_t const manchester_lut[256] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x23, 0x23, 0x23, 0x23, 0x37, 0x4f, 0x4e, 0x37, 0x36, 0x4d, 0x4c, 0x36, 0x23, 0x23, 0x23, 0x23,
+        0x22, 0x22, 0x22, 0x22, 0x35, 0x4b, 0x4a, 0x35, 0x34, 0x49, 0x48, 0x34, 0x22, 0x22, 0x22, 0x22,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x21, 0x21, 0x21, 0x21, 0x33, 0x47, 0x46, 0x33, 0x32, 0x45, 0x44, 0x32, 0x21, 0x21, 0x21, 0x21,
+        0x20, 0x20, 0x20, 0x20, 0x31, 0x43, 0x42, 0x31, 0x30, 0x41, 0x40, 0x30, 0x20, 0x20, 0x20, 0x20,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
 unsigned bitbuffer_manchester_decode(bitbuffer_t *inbuf, unsigned row, unsigned start,
         bitbuffer_t *outbuf, unsigned max)
 {
@@ -255,16 +534,25 @@ unsigned bitbuffer_manchester_decode(bitbuffer_t *inbuf, unsigned row, unsigned
     if (max && len > start + (max * 2))
         len = start + (max * 2);
 
+    // An odd length reads one bit past len, as a bit-at-a-time decode would
+    unsigned const row_bytes = (BITBUF_ROWS - row) * BITBUF_COLS;
+    unsigned const end       = len / 8 + 1 < row_bytes ? len / 8 + 1 : row_bytes;
+
+    // Four pairs per lookup
     while (ipos < len) {
-        uint8_t bit1, bit2;
+        unsigned const pairs = (len - ipos + 1) / 2;
+        uint8_t const symbol = manchester_lut[bitrow_get_word(bits, ipos, end) >> 24];
+        unsigned const valid = symbol >> 4;
+        unsigned const count = valid < pairs ? valid : pairs;
 
-        bit1 = bit_at(bits, ipos++);
-        bit2 = bit_at(bits, ipos++);
+        if (count)
+            bitbuffer_add_bits(outbuf, (symbol & 0xf) >> (valid - count), count);
+        ipos += count * 2;
 
-        if (bit1 == bit2)
+        if (valid < 4 && valid < pairs) {
+            ipos += 2; // Skip the invalid pair
             break;
-
-        bitbuffer_add_bit(outbuf, bit2);
+        }
     }
 
     return ipos;
@@ -533,6 +821,16 @@ int bitbuffer_find_repeated_prefix(bitbuffer_t *bits, unsigned min_repeats, unsi
         } \
     } while (0)
 
+static int bitbuffer_is_zero(bitbuffer_t const *bits)
+{
+    uint8_t const *p = (uint8_t const *)bits;
+    for (size_t i = 0; i < sizeof(*bits); ++i) {
+        if (p[i])
+            return 0;
+    }
+    return 1;
+}
+
 int main(void)
 {
     unsigned passed = 0;
@@ -571,6 +869,28 @@ int main(void)
     bitbuffer_print(&bits);
     ASSERT(bits.num_rows == 3);
 
+    fprintf(stderr, "TEST: bitbuffer:: Add bits in words\n");
+    bitbuffer_t words = {0};
+    bitbuffer_t single = {0};
+    for (unsigned i = 0, n = 1; i < 40; ++i, n = n * 7 % 33) {
+        uint32_t word = 0x9e3779b9 * (i + 1);
+        bitbuffer_add_bits(&words, word, n);
+        for (unsigned k = n; k > 0; --k) {
+            bitbuffer_add_bit(&single, (word >> (k - 1)) & 1);
+        }
+        if (i % 9 == 8) {
+            bitbuffer_add_row(&words);
+            bitbuffer_add_row(&single);
+        }
+    }
+    for (int i = 0; i < BITBUF_COLS * 8 + 9; ++i) {
+        bitbuffer_add_bits(&words, i, 3);
+        bitbuffer_add_bit(&single, (i >> 2) & 1);
+        bitbuffer_add_bit(&single, (i >> 1) & 1);
+        bitbuffer_add_bit(&single, i & 1);
+    }
+    ASSERT(memcmp(&words, &single, sizeof(words)) == 0);
+
     fprintf(stderr, "TEST: bitbuffer:: invert\n");
     bitbuffer_invert(&bits);
     bitbuffer_print(&bits);
@@ -588,8 +908,86 @@ int main(void)
     fprintf(stderr, "TEST: bitbuffer:: Clear\n");
     bitbuffer_clear(&bits);
     ASSERT(bits.num_rows == 0);
+    ASSERT(bitbuffer_is_zero(&bits));
     bitbuffer_print(&bits);
 
+    fprintf(stderr, "TEST: bitbuffer:: Clear after shrinking a row\n");
+    bitbuffer_add_bit(&bits, 1);
+    bitbuffer_add_row(&bits);
+    for (int i = 0; i < 40; ++i) {
+        bitbuffer_add_bit(&bits, 1);
+    }
+    bits.bits_per_row[1] = 0;
+    bitbuffer_clear(&bits);
+    ASSERT(bitbuffer_is_zero(&bits));
+
+    fprintf(stderr, "TEST: bitbuffer:: Clear after dropping rows and writing past a row\n");
+    bitbuffer_add_bit(&bits, 1);
+    bitbuffer_add_row(&bits);
+    bitbuffer_add_bit(&bits, 1);
+    bits.num_rows = bits.free_row = 1;
+    bitbuffer_clear(&bits);
+    ASSERT(bitbuffer_is_zero(&bits));
+    bitbuffer_add_bit(&bits, 1);
+    bits.bb[0][4] = 0xff;
+    bitbuffer_touch(&bits);
+    bitbuffer_clear(&bits);
+    ASSERT(bitbuffer_is_zero(&bits));
+
+    fprintf(stderr, "TEST: bitbuffer:: Copy\n");
+    bitbuffer_t copy = {0};
+    for (int i = 0; i < BITBUF_COLS * 8 + 20; ++i) {
+        bitbuffer_add_bit(&copy, 1);
+    }
+    bitbuffer_add_sync(&copy);
+    bitbuffer_add_bit(&bits, 1);
+    bitbuffer_add_row(&bits);
+    bitbuffer_add_bit(&bits, 0);
+    bitbuffer_add_bit(&bits, 1);
+    bitbuffer_copy(&copy, &bits);
+    ASSERT(memcmp(&copy, &bits, offsetof(bitbuffer_t, dirty_rows)) == 0);
+    ASSERT(memcmp(copy.bits_per_row, bits.bits_per_row, sizeof(bitbuffer_t) - offsetof(bitbuffer_t, bits_per_row)) == 0);
+    bitbuffer_clear(&bits);
+
+    fprintf(stderr, "TEST: bitbuffer:: Search with shared preambles\n");
+    static bitbuffer_preambles_t preambles = {0};
+    uint8_t const sync[]     = {0xaa, 0x2d, 0xd4};
+    uint8_t const other[]    = {0x2d, 0xd4};
+    bitbuffer_parse(&bits, "{60}aaaaa2dd4a2dd40{12}aaa");
+    bitbuffer_share_preambles(&bits, &preambles);
+    ASSERT(bitbuffer_search(&bits, 0, 0, sync, 24) == 12);
+    ASSERT(bitbuffer_search(&bits, 0, 0, other, 16) == 20);
+    ASSERT(bitbuffer_search(&bits, 0, 13, sync, 24) == 60);
+    ASSERT(bitbuffer_search(&bits, 0, 21, other, 16) == 40);
+    ASSERT(bitbuffer_search(&bits, 0, 0, other, 16) == 20);
+    ASSERT(bitbuffer_search(&bits, 1, 0, sync, 24) == 12);
+    ASSERT(preambles.num_patterns == 2);
+    bitbuffer_copy(&copy, &bits);
+    ASSERT(copy.preambles == &preambles);
+    ASSERT(bitbuffer_search(&copy, 0, 0, sync, 24) == 12);
+    bitbuffer_invert(&copy);
+    ASSERT(copy.preambles == NULL);
+    ASSERT(bitbuffer_search(&copy, 0, 0, sync, 24) == 60);
+    ASSERT(bitbuffer_search(&bits, 0, 0, sync, 24) == 12);
+    bitbuffer_copy(&copy, &bits);
+    bitbuffer_add_bit(&copy, 0);
+    ASSERT(copy.preambles == NULL);
+    bitbuffer_copy(&copy, &bits);
+    copy.bb[0][2] = 0; // a direct write to a copy is announced with a touch
+    bitbuffer_touch(&copy);
+    ASSERT(copy.preambles == NULL);
+    ASSERT(bitbuffer_search(&copy, 0, 0, sync, 24) == 60);
+    copy.bb[0][0] = 0xaa; // an earlier match than in the slice
+    copy.bb[0][1] = 0x2d;
+    copy.bb[0][2] = 0xd4;
+    ASSERT(bitbuffer_search(&copy, 0, 0, sync, 24) == 0);
+    ASSERT(bitbuffer_search(&copy, 0, 0, other, 16) == 8);
+    copy.bb[1][0] = 0xd4; // a match where the slice has none
+    ASSERT(bitbuffer_search(&bits, 1, 0, &other[1], 8) == 12);
+    ASSERT(bitbuffer_search(&copy, 1, 0, &other[1], 8) == 0);
+    ASSERT(bitbuffer_search(&bits, 0, 0, sync, 24) == 12); // the slice is unchanged
+    bitbuffer_clear(&bits);
+
     fprintf(stderr, "TEST: bitbuffer:: Add 1 row too many\n");
     for (int i = 0; i <= BITBUF_ROWS; ++i) {
         bitbuffer_add_row(&bits);
@@ -602,3 +1000,211 @@ int main(void)
     return failed > 0 ? 1 : 0;
 }
 #endif /* _TEST */
+
+// Microbenchmark, build with -D_BENCH
+#ifdef _BENCH
+
+#include <time.h>
+
+/// Copy of the previous bitbuffer_clear() for comparison.
+static void bitbuffer_clear_full(bitbuffer_t *bits)
+{
+    memset(bits, 0, sizeof(*bits));
+}
+
+/// Decoder stand-in, searches each row for a preamble.
+static void decode_search(bitbuffer_t *bits)
+{
+    uint8_t const preamble[] = {0xaa, 0x2d};
+    for (unsigned row = 0; row < bits->num_rows; ++row) {
+        bitbuffer_search(bits, row, 0, preamble, 16);
+    }
+}
+
+/// Decoder stand-in that marks every column written, like each decode did before.
+static void decode_search_touch(bitbuffer_t *bits)
+{
+    decode_search(bits);
+    bitbuffer_touch(bits);
+}
+
+/// Time slices of three rows of row_bits bits, each decoded if decode is set
+/// and followed by a clear.
+static double bench_slice(void (*volatile clear)(bitbuffer_t *), void (*volatile decode)(bitbuffer_t *),
+        unsigned row_bits, unsigned rounds)
+{
+    static bitbuffer_t bits = {0};
+    clock_t start = clock();
+    for (unsigned n = 0; n < rounds; ++n) {
+        for (unsigned row = 0; row < 3; ++row) {
+            for (unsigned i = 0; i < row_bits; i += 32) {
+                bitbuffer_add_bits(&bits, 0x55555555 ^ n, row_bits - i < 32 ? row_bits - i : 32);
+            }
+            bitbuffer_add_row(&bits);
+        }
+        if (decode)
+            decode(&bits);
+        clear(&bits);
+    }
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/// Copy of the previous bit-at-a-time bitbuffer_search() for comparison.
+static unsigned bitbuffer_search_bitwise(bitbuffer_t *bitbuffer, unsigned row, unsigned start,
+        const uint8_t *pattern, unsigned pattern_bits_len)
+{
+    uint8_t *bits = bitbuffer->bb[row];
+    unsigned len  = bitbuffer->bits_per_row[row];
+    unsigned ipos = start;
+    unsigned ppos = 0; // cursor on init pattern
+
+    while (ipos < len && ppos < pattern_bits_len) {
+        if (bit_at(bits, ipos) == bit_at(pattern, ppos)) {
+            ppos++;
+            ipos++;
+            if (ppos == pattern_bits_len)
+                return ipos - pattern_bits_len;
+        }
+        else {
+            ipos -= ppos;
+            ipos++;
+            ppos = 0;
+        }
+    }
+    return len;
+}
+
+/// Copy of the previous bit-at-a-time bitbuffer_manchester_decode() for comparison.
+static unsigned bitbuffer_manchester_decode_bitwise(bitbuffer_t *inbuf, unsigned row, unsigned start,
+        bitbuffer_t *outbuf, unsigned max)
+{
+    uint8_t *bits     = inbuf->bb[row];
+    unsigned int len  = inbuf->bits_per_row[row];
+    unsigned int ipos = start;
+
+    if (max && len > start + (max * 2))
+        len = start + (max * 2);
+
+    while (ipos < len) {
+        uint8_t bit1 = bit_at(bits, ipos++);
+        uint8_t bit2 = bit_at(bits, ipos++);
+        if (bit1 == bit2)
+            break;
+        bitbuffer_add_bit(outbuf, bit2);
+    }
+    return ipos;
+}
+
+/// Copy of the previous byte-wise bitbuffer_nrzs_decode() for comparison.
+static void bitbuffer_nrzs_decode_bytewise(bitbuffer_t *bits)
+{
+    for (unsigned row = 0; row < bits->num_rows; ++row) {
+        if (bits->bits_per_row[row] > 0) {
+            uint8_t *b = bits->bb[row];
+
+            const unsigned last_col  = (bits->bits_per_row[row] - 1) / 8;
+            const unsigned last_bits = ((bits->bits_per_row[row] - 1) % 8) + 1;
+
+            int prev = 0;
+            for (unsigned col = 0; col <= last_col; ++col) {
+                int mask = (prev << 7) | b[col] >> 1;
+                prev     = b[col];
+                b[col]   = b[col] ^ ~mask;
+            }
+            b[last_col] &= 0xFF << (8 - last_bits); // Clear unused bits in last byte
+        }
+    }
+}
+
+typedef unsigned (*search_fn)(bitbuffer_t *, unsigned, unsigned, const uint8_t *, unsigned);
+typedef unsigned (*manchester_fn)(bitbuffer_t *, unsigned, unsigned, bitbuffer_t *, unsigned);
+
+/// Time searches for a 16 bit sync word at the end of a 1024 bit row of preamble.
+static double bench_search(search_fn volatile search, unsigned rounds)
+{
+    static bitbuffer_t bits = {0};
+    uint8_t const pattern[] = {0x2d, 0xd4};
+    bitbuffer_clear(&bits);
+    for (unsigned i = 0; i < 1000; ++i) {
+        bitbuffer_add_bit(&bits, i & 1);
+    }
+    bitbuffer_add_bits(&bits, 0x2dd4, 16);
+    unsigned found = 0;
+    clock_t start  = clock();
+    for (unsigned n = 0; n < rounds; ++n) {
+        found += search(&bits, 0, n & 7, pattern, 16);
+    }
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    return found == rounds * 1000 ? elapsed : -1.0;
+}
+
+/// Time Manchester decodes of a 1024 bit row.
+static double bench_manchester(manchester_fn volatile decode, unsigned rounds)
+{
+    static bitbuffer_t bits = {0};
+    static bitbuffer_t out  = {0};
+    bitbuffer_clear(&bits);
+    for (unsigned i = 0; i < 512; ++i) {
+        bitbuffer_add_bits(&bits, (i * 7 >> 3) & 1 ? 1 : 2, 2);
+    }
+    unsigned decoded = 0;
+    clock_t start    = clock();
+    for (unsigned n = 0; n < rounds; ++n) {
+        bitbuffer_clear(&out);
+        decoded += decode(&bits, 0, 0, &out, 0);
+    }
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    return decoded == rounds * 1024 ? elapsed : -1.0;
+}
+
+/// Time NRZS decodes of three 1024 bit rows.
+static double bench_nrzs(void (*volatile decode)(bitbuffer_t *), unsigned rounds)
+{
+    static bitbuffer_t bits = {0};
+    bitbuffer_clear(&bits);
+    for (unsigned row = 0; row < 3; ++row) {
+        for (unsigned i = 0; i < 1024; ++i) {
+            bitbuffer_add_bit(&bits, (i * 5 >> 2) & 1);
+        }
+        bitbuffer_add_row(&bits);
+    }
+    clock_t start = clock();
+    for (unsigned n = 0; n < rounds; ++n) {
+        decode(&bits);
+    }
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(void)
+{
+    unsigned const rounds = 200000;
+    unsigned const lengths[] = {0, 8, 64, 256, BITBUF_COLS * 8};
+
+    fprintf(stderr, "bitbuffer:: clear benchmark, %u slices of 3 rows\n", rounds);
+    for (unsigned i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        double full = bench_slice(bitbuffer_clear_full, NULL, lengths[i], rounds);
+        double used = bench_slice(bitbuffer_clear, NULL, lengths[i], rounds);
+        fprintf(stderr, "%4u bits per row: full clear %.3f s, used rows/cols %.3f s, %.0f ns saved per slice\n",
+                lengths[i], full, used, (full - used) * 1e9 / rounds);
+    }
+    fprintf(stderr, "bitbuffer:: decode and clear benchmark, %u slices of 3 rows\n", rounds);
+    for (unsigned i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        double full    = bench_slice(bitbuffer_clear_full, decode_search, lengths[i], rounds);
+        double touched = bench_slice(bitbuffer_clear, decode_search_touch, lengths[i], rounds);
+        double used    = bench_slice(bitbuffer_clear, decode_search, lengths[i], rounds);
+        fprintf(stderr, "%4u bits per row: full clear %.3f s, all columns touched %.3f s, widest row %.3f s\n",
+                lengths[i], full, touched, used);
+    }
+
+    fprintf(stderr, "bitbuffer:: search benchmark, %u searches in 1016 bits\n", rounds);
+    fprintf(stderr, "bit-at-a-time %.3f s, word windowed %.3f s\n",
+            bench_search(bitbuffer_search_bitwise, rounds), bench_search(bitbuffer_search, rounds));
+    fprintf(stderr, "bitbuffer:: manchester benchmark, %u decodes of 1024 bits\n", rounds);
+    fprintf(stderr, "bit-at-a-time %.3f s, lookup table %.3f s\n",
+            bench_manchester(bitbuffer_manchester_decode_bitwise, rounds), bench_manchester(bitbuffer_manchester_decode, rounds));
+    fprintf(stderr, "bitbuffer:: nrzs benchmark, %u decodes of 3 rows of 1024 bits\n", rounds);
+    fprintf(stderr, "byte-wise %.3f s, word-wise %.3f s\n",
+            bench_nrzs(bitbuffer_nrzs_decode_bytewise, rounds), bench_nrzs(bitbuffer_nrzs_decode, rounds));
+    return 0;
+}
+#endif /* _BENCH */
@@ -29,16 +29,158 @@ r_device *create_device(r_device const *dev_template)
     return r_dev;
 }
 
+r_device *decoder_create(r_device const *dev_template, unsigned user_data_size)
+{
+    r_device *r_dev = calloc(1, sizeof (*r_dev));
+    if (!r_dev) {
+        WARN_MALLOC("decoder_create()");
+        return NULL; // NOTE: returns NULL on alloc failure.
+    }
+    if (dev_template)
+        *r_dev = *dev_template; // copy
+
+    if (user_data_size) {
+        r_dev->decode_ctx = calloc(1, user_data_size);
+        if (!r_dev->decode_ctx) {
+            WARN_MALLOC("decoder_create()");
+            free(r_dev);
+            return NULL; // NOTE: returns NULL on alloc failure.
+        }
+    }
+
+    return r_dev;
+}
+
+void *decoder_user_data(r_device *decoder)
+{
+    r_device_state *state = decoder_state(decoder);
+    return state ? state->decode_ctx : decoder->decode_ctx;
+}
+
+// decoder states
+
+// Registered states, open addressed with linear probing on the decoder address.
+static r_device_state **state_table;
+static unsigned state_table_size; // power of two
+static unsigned state_table_len;
+static int state_table_verbose; // highest verbosity of the linked states
+
+static unsigned state_slot(r_device const *decoder)
+{
+    uint32_t key = (uint32_t)((uintptr_t)decoder >> 2);
+    return (key * 2654435761u) & (state_table_size - 1);
+}
+
+static void state_table_put(r_device_state *state)
+{
+    unsigned i = state_slot(state->device);
+    while (state_table[i] && state_table[i]->device != state->device) {
+        i = (i + 1) & (state_table_size - 1);
+    }
+    if (!state_table[i]) {
+        state_table_len++;
+    }
+    state_table[i] = state;
+}
+
+void decoder_link_state(r_device_state *state)
+{
+    if (2 * (state_table_len + 1) > state_table_size) {
+        r_device_state **old = state_table;
+        unsigned old_size    = state_table_size;
+        state_table_size     = old_size ? 2 * old_size : 256;
+        state_table          = calloc(state_table_size, sizeof(*state_table));
+        if (!state_table) {
+            FATAL_CALLOC("decoder_link_state()");
+        }
+        state_table_len = 0;
+        for (unsigned i = 0; i < old_size; ++i) {
+            if (old[i]) {
+                state_table_put(old[i]);
+            }
+        }
+        free(old);
+    }
+    state_table_put(state);
+    if (state->verbose > state_table_verbose) {
+        state_table_verbose = state->verbose;
+    }
+}
+
+void decoder_unlink_state(r_device_state *state)
+{
+    if (!state_table_len) {
+        return;
+    }
+    unsigned i = state_slot(state->device);
+    while (state_table[i] && state_table[i] != state) {
+        i = (i + 1) & (state_table_size - 1);
+    }
+    if (!state_table[i]) {
+        return; // not linked, or replaced by a later registration
+    }
+    state_table[i] = NULL;
+    state_table_len--;
+    // reinsert the rest of the cluster so lookups don't stop at the hole
+    for (i = (i + 1) & (state_table_size - 1); state_table[i]; i = (i + 1) & (state_table_size - 1)) {
+        r_device_state *moved = state_table[i];
+        state_table[i]        = NULL;
+        state_table_len--;
+        state_table_put(moved);
+    }
+    state_table_verbose = 0;
+    for (i = 0; i < state_table_size; ++i) {
+        if (state_table[i] && state_table[i]->verbose > state_table_verbose) {
+            state_table_verbose = state_table[i]->verbose;
+        }
+    }
+}
+
+r_device_state *decoder_state(r_device const *decoder)
+{
+    if (!state_table_len) {
+        return NULL;
+    }
+    unsigned i = state_slot(decoder);
+    while (state_table[i]) {
+        if (state_table[i]->device == decoder) {
+            return state_table[i];
+        }
+        i = (i + 1) & (state_table_size - 1);
+    }
+    return NULL; // unregistered, e.g. from the pulse analyzer
+}
+
+/// State of a decoder logging at level, NULL if the decoder is not that verbose.
+static r_device_state *verbose_state(r_device const *decoder, int level)
+{
+    if (level > state_table_verbose) {
+        return NULL; // no lookup for the common case of quiet decoders
+    }
+    r_device_state *state = decoder_state(decoder);
+    return state && state->verbose >= level ? state : NULL;
+}
+
 // output functions
 
 void decoder_output_log(r_device *decoder, int level, data_t *data)
 {
-    decoder->log_fn(decoder, level, data);
+    r_device_state *state = decoder_state(decoder);
+    if (!state) {
+        data_free(data);
+        return;
+    }
+    state->log_fn(state, level, data);
 }
 
 void decoder_output_data(r_device *decoder, data_t *data)
 {
-    decoder->output_fn(decoder, data);
+    r_device_state *state = decoder_state(decoder);
+    if (!state) {
+        data_free(data);
+        return;
+    }
+    state->output_fn(state, data);
 }
 
 // helper
@@ -98,7 +240,8 @@ static char *bitrow_asprint_bits(uint8_t const *bitrow, unsigned bit_len)
 
 void decoder_log(r_device *decoder, int level, char const *func, char const *msg)
 {
-    if (decoder->verbose >= level) {
+    r_device_state *state = verbose_state(decoder, level);
+    if (state) {
         // note that decoder levels start at LOG_WARNING
         level += 4;
 
@@ -109,18 +252,19 @@ void decoder_log(r_device *decoder, int level, char const *func, char const *msg
                 "msg",      "",     DATA_STRING, msg,
                 NULL);
         /* clang-format on */
-        decoder_output_log(decoder, level, data);
+        state->log_fn(state, level, data);
     }
 }
 
 int decoder_verbose(r_device *decoder)
 {
-    return decoder->verbose;
+    r_device_state *state = decoder_state(decoder);
+    return state ? state->verbose : 0;
 }
 
 void decoder_logf(r_device *decoder, int level, char const *func, _Printf_format_string_ const char *format, ...)
 {
-    if (decoder->verbose >= level) {
+    if (verbose_state(decoder, level)) {
         char msg[60]; // fixed length limit
         va_list ap;
         va_start(ap, format);
@@ -133,7 +277,8 @@ void decoder_logf(r_device *decoder, int level, char const *func, _Printf_format
 
 void decoder_log_bitbuffer(r_device *decoder, int level, char const *func, const bitbuffer_t *bitbuffer, char const *msg)
 {
-    if (decoder->verbose >= level) {
+    r_device_state *state = verbose_state(decoder, level);
+    if (state) {
         // note that decoder levels start at LOG_WARNING
         level += 4;
 
@@ -143,7 +288,7 @@ void decoder_log_bitbuffer(r_device *decoder, int level, char const *func, const
         for (unsigned i = 0; i < bitbuffer->num_rows; i++) {
             row_codes[i] = bitrow_asprint_code(bitbuffer->bb[i], bitbuffer->bits_per_row[i]);
 
-            if (decoder->verbose_bits) {
+            if (state->verbose_bits) {
                 row_bits[i] = bitrow_asprint_bits(bitbuffer->bb[i], bitbuffer->bits_per_row[i]);
             }
         }
@@ -158,13 +303,13 @@ void decoder_log_bitbuffer(r_device *decoder, int level, char const *func, const
                 NULL);
         /* clang-format on */
 
-        if (decoder->verbose_bits) {
+        if (state->verbose_bits) {
             data_append(data,
                     "bits", "", DATA_ARRAY, data_array(bitbuffer->num_rows, DATA_STRING, row_bits),
                     NULL);
         }
 
-        decoder_output_log(decoder, level, data);
+        state->log_fn(state, level, data);
 
         for (unsigned i = 0; i < bitbuffer->num_rows; i++) {
             free(row_codes[i]);
@@ -176,7 +321,7 @@ void decoder_log_bitbuffer(r_device *decoder, int level, char const *func, const
 void decoder_logf_bitbuffer(r_device *decoder, int level, char const *func, const bitbuffer_t *bitbuffer, _Printf_format_string_ const char *format, ...)
 {
     // TODO: pass to interested outputs
-    if (decoder->verbose >= level) {
+    if (verbose_state(decoder, level)) {
         char msg[60]; // fixed length limit
         va_list ap;
         va_start(ap, format);
@@ -189,7 +334,8 @@ void decoder_logf_bitbuffer(r_device *decoder, int level, char const *func, cons
 
 void decoder_log_bitrow(r_device *decoder, int level, char const *func, uint8_t const *bitrow, unsigned bit_len, char const *msg)
 {
-    if (decoder->verbose >= level) {
+    r_device_state *state = verbose_state(decoder, level);
+    if (state) {
         // note that decoder levels start at LOG_WARNING
         level += 4;
 
@@ -207,14 +353,14 @@ void decoder_log_bitrow(r_device *decoder, int level, char const *func, uint8_t
                 NULL);
         /* clang-format on */
 
-        if (decoder->verbose_bits) {
+        if (state->verbose_bits) {
             row_bits = bitrow_asprint_bits(bitrow, bit_len);
             data_append(data,
                     "bits", "", DATA_STRING, row_bits,
                     NULL);
         }
 
-        decoder_output_log(decoder, level, data);
+        state->log_fn(state, level, data);
 
         free(row_code);
         free(row_bits);
@@ -223,7 +369,7 @@ void decoder_log_bitrow(r_device *decoder, int level, char const *func, uint8_t
 
 void decoder_logf_bitrow(r_device *decoder, int level, char const *func, uint8_t const *bitrow, unsigned bit_len, _Printf_format_string_ const char *format, ...)
 {
-    if (decoder->verbose >= level) {
+    if (verbose_state(decoder, level)) {
         char msg[60]; // fixed length limit
         va_list ap;
         va_start(ap, format);
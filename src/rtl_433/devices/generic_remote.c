@@ -27,6 +27,7 @@ static int generic_remote_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     char *p = tristate;
 
     //invert bits, short pulse is 0, long pulse is 1
+    bitbuffer_touch(bitbuffer); // bytes past a short row are inverted too
     b[0] = ~b[0];
     b[1] = ~b[1];
     b[2] = ~b[2];
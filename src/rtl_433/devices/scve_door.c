@@ -32,6 +32,7 @@ with a repeat gap of 4 pulse widths, i.e.:
 
 static int scve_door_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
+    bitbuffer_touch(bitbuffer); // bytes past short rows are inverted too
     for (int i = 0; i < bitbuffer->num_rows; ++i) {
         uint8_t *b = bitbuffer->bb[i];
 
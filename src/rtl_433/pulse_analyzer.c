@@ -17,7 +17,7 @@
 #include <string.h>
 #include <limits.h>
 
-#define MAX_HIST_BINS 16
+#define MAX_HIST_BINS PULSE_TIMING_BINS
 
 /// Histogram data for single bin
 typedef struct {
@@ -34,32 +34,41 @@ typedef struct {
     hist_bin_t bins[MAX_HIST_BINS];
 } histogram_t;
 
+/// Width accessor for histogram_sum()
+typedef int (*width_fn_t)(pulse_data_t const *data, unsigned n);
+
+/// Width of pulse n plus the following gap
+static int pulse_data_get_period(pulse_data_t const *data, unsigned n)
+{
+    return pulse_data_get_pulse(data, n) + pulse_data_get_gap(data, n);
+}
+
 /// Generate a histogram (unsorted)
-static void histogram_sum(histogram_t *hist, int const *data, unsigned len, float tolerance)
+static void histogram_sum(histogram_t *hist, pulse_data_t const *data, width_fn_t width, unsigned len, float tolerance)
 {
     unsigned bin;    // Iterator will be used outside for!
 
     for (unsigned n = 0; n < len; ++n) {
+        int bn = width(data, n);
         // Search for match in existing bins
         for (bin = 0; bin < hist->bins_count; ++bin) {
-            int bn = data[n];
             int bm = hist->bins[bin].mean;
             if (abs(bn - bm) < (tolerance * MAX(bn, bm))) {
                 hist->bins[bin].count++;
-                hist->bins[bin].sum += data[n];
+                hist->bins[bin].sum += bn;
                 hist->bins[bin].mean = hist->bins[bin].sum / hist->bins[bin].count;
-                hist->bins[bin].min    = MIN(data[n], hist->bins[bin].min);
-                hist->bins[bin].max    = MAX(data[n], hist->bins[bin].max);
+                hist->bins[bin].min    = MIN(bn, hist->bins[bin].min);
+                hist->bins[bin].max    = MAX(bn, hist->bins[bin].max);
                 break;    // Match found! Data added to existing bin
             }
         }
         // No match found? Add new bin
         if (bin == hist->bins_count && bin < MAX_HIST_BINS) {
             hist->bins[bin].count    = 1;
-            hist->bins[bin].sum        = data[n];
-            hist->bins[bin].mean    = data[n];
-            hist->bins[bin].min        = data[n];
-            hist->bins[bin].max        = data[n];
+            hist->bins[bin].sum        = bn;
+            hist->bins[bin].mean    = bn;
+            hist->bins[bin].min        = bn;
+            hist->bins[bin].max        = bn;
             hist->bins_count++;
         } // for bin
     } // for data
@@ -213,13 +222,10 @@ void pulse_analyzer(pulse_data_t *data, int package_type)
     double to_us = 1e6 / data->sample_rate;
     // Generate pulse period data
     int pulse_total_period = 0;
-    pulse_data_t pulse_periods = {0};
-    pulse_periods.num_pulses = data->num_pulses;
-    for (unsigned n = 0; n < pulse_periods.num_pulses; ++n) {
-        pulse_periods.pulse[n] = data->pulse[n] + data->gap[n];
-        pulse_total_period += data->pulse[n] + data->gap[n];
+    for (unsigned n = 0; n < data->num_pulses; ++n) {
+        pulse_total_period += pulse_data_get_period(data, n);
     }
-    pulse_total_period -= data->gap[pulse_periods.num_pulses - 1];
+    pulse_total_period -= pulse_data_get_gap(data, data->num_pulses - 1);
 
     histogram_t hist_pulses  = {0};
     histogram_t hist_gaps    = {0};
@@ -227,11 +233,11 @@ void pulse_analyzer(pulse_data_t *data, int package_type)
     histogram_t hist_timings = {0};
 
     // Generate statistics
-    histogram_sum(&hist_pulses, data->pulse, data->num_pulses, TOLERANCE);
-    histogram_sum(&hist_gaps, data->gap, data->num_pulses - 1, TOLERANCE);                      // Leave out last gap (end)
-    histogram_sum(&hist_periods, pulse_periods.pulse, pulse_periods.num_pulses - 1, TOLERANCE); // Leave out last gap (end)
-    histogram_sum(&hist_timings, data->pulse, data->num_pulses, TOLERANCE);
-    histogram_sum(&hist_timings, data->gap, data->num_pulses, TOLERANCE);
+    histogram_sum(&hist_pulses, data, pulse_data_get_pulse, data->num_pulses, TOLERANCE);
+    histogram_sum(&hist_gaps, data, pulse_data_get_gap, data->num_pulses - 1, TOLERANCE);             // Leave out last gap (end)
+    histogram_sum(&hist_periods, data, pulse_data_get_period, data->num_pulses - 1, TOLERANCE);       // Leave out last gap (end)
+    histogram_sum(&hist_timings, data, pulse_data_get_pulse, data->num_pulses, TOLERANCE);
+    histogram_sum(&hist_timings, data, pulse_data_get_gap, data->num_pulses, TOLERANCE);
 
     // Fuse overlapping bins
     histogram_fuse_bins(&hist_pulses, TOLERANCE);
@@ -355,8 +361,8 @@ void pulse_analyzer(pulse_data_t *data, int package_type)
                 hexstr_push_word(&hexstr, w < USHRT_MAX ? w : USHRT_MAX);
             }
             for (unsigned i = 0; i < data->num_pulses; ++i) {
-                int p = histogram_find_bin_index(&hist_timings, data->pulse[i]);
-                int g = histogram_find_bin_index(&hist_timings, data->gap[i]);
+                int p = histogram_find_bin_index(&hist_timings, pulse_data_get_pulse(data, i));
+                int g = histogram_find_bin_index(&hist_timings, pulse_data_get_gap(data, i));
                 if (p < 0 || g < 0) {
                     fprintf(stderr, "%s: this can't happen\n", __func__);
                     exit(1);
@@ -388,14 +394,14 @@ void pulse_analyzer(pulse_data_t *data, int package_type)
                     hexstr_push_word(hexstr, w < USHRT_MAX ? w : USHRT_MAX);
                 }
                 for (; i < data->num_pulses; ++i) {
-                    int p = histogram_find_bin_index(&hist_timings, data->pulse[i]);
-                    int g = histogram_find_bin_index(&hist_timings, data->gap[i]);
+                    int p = histogram_find_bin_index(&hist_timings, pulse_data_get_pulse(data, i));
+                    int g = histogram_find_bin_index(&hist_timings, pulse_data_get_gap(data, i));
                     if (p < 0 || g < 0) {
                         fprintf(stderr, "%s: this can't happen\n", __func__);
                         exit(1);
                     }
                     hexstr_push_byte(hexstr, 0x80 | (p << 4) | g);
-                    if (data->gap[i] >= limit) {
+                    if (pulse_data_get_gap(data, i) >= limit) {
                         ++i;
                         break;
                     }
@@ -425,7 +431,9 @@ void pulse_analyzer(pulse_data_t *data, int package_type)
     }
 
     // Demodulate (if detected)
-    if (device.modulation) {
+    pulse_slicer_ctx_t *ctx = device.modulation ? calloc(1, sizeof(*ctx)) : NULL;
+    if (ctx) {
+        r_device_state state = {.device = &device}; // unregistered
         fprintf(stderr, "Attempting demodulation... short_width: %.0f, long_width: %.0f, reset_limit: %.0f, sync_width: %.0f\n",
                 device.short_width, device.long_width,
                 device.reset_limit, device.sync_width);
@@ -433,39 +441,245 @@ void pulse_analyzer(pulse_data_t *data, int package_type)
         case FSK_PULSE_PCM:
             fprintf(stderr, "Use a flex decoder with -X 'n=name,m=FSK_PCM,s=%.0f,l=%.0f,r=%.0f'\n",
                     device.short_width, device.long_width, device.reset_limit);
-            pulse_slicer_pcm(data, &device);
+            pulse_slicer_pcm(ctx, data, &state);
             break;
         case OOK_PULSE_PPM:
             fprintf(stderr, "Use a flex decoder with -X 'n=name,m=OOK_PPM,s=%.0f,l=%.0f,g=%.0f,r=%.0f'\n",
                     device.short_width, device.long_width,
                     device.gap_limit, device.reset_limit);
-            data->gap[data->num_pulses - 1] = device.reset_limit / to_us + 1; // Be sure to terminate package
-            pulse_slicer_ppm(data, &device);
+            pulse_data_set_gap(data, data->num_pulses - 1, device.reset_limit / to_us + 1); // Be sure to terminate package
+            pulse_slicer_ppm(ctx, data, &state);
             break;
         case OOK_PULSE_PWM:
             fprintf(stderr, "Use a flex decoder with -X 'n=name,m=OOK_PWM,s=%.0f,l=%.0f,r=%.0f,g=%.0f,t=%.0f,y=%.0f'\n",
                     device.short_width, device.long_width, device.reset_limit,
                     device.gap_limit, device.tolerance, device.sync_width);
-            data->gap[data->num_pulses - 1] = device.reset_limit / to_us + 1; // Be sure to terminate package
-            pulse_slicer_pwm(data, &device);
+            pulse_data_set_gap(data, data->num_pulses - 1, device.reset_limit / to_us + 1); // Be sure to terminate package
+            pulse_slicer_pwm(ctx, data, &state);
             break;
         case FSK_PULSE_PWM:
             fprintf(stderr, "Use a flex decoder with -X 'n=name,m=FSK_PWM,s=%.0f,l=%.0f,r=%.0f,g=%.0f,t=%.0f,y=%.0f'\n",
                     device.short_width, device.long_width, device.reset_limit,
                     device.gap_limit, device.tolerance, device.sync_width);
-            data->gap[data->num_pulses - 1] = device.reset_limit / to_us + 1; // Be sure to terminate package
-            pulse_slicer_pwm(data, &device);
+            pulse_data_set_gap(data, data->num_pulses - 1, device.reset_limit / to_us + 1); // Be sure to terminate package
+            pulse_slicer_pwm(ctx, data, &state);
             break;
         case OOK_PULSE_MANCHESTER_ZEROBIT:
             fprintf(stderr, "Use a flex decoder with -X 'n=name,m=OOK_MC_ZEROBIT,s=%.0f,l=%.0f,r=%.0f'\n",
                     device.short_width, device.long_width, device.reset_limit);
-            data->gap[data->num_pulses - 1] = device.reset_limit / to_us + 1; // Be sure to terminate package
-            pulse_slicer_manchester_zerobit(data, &device);
+            pulse_data_set_gap(data, data->num_pulses - 1, device.reset_limit / to_us + 1); // Be sure to terminate package
+            pulse_slicer_manchester_zerobit(ctx, data, &state);
             break;
         default:
             fprintf(stderr, "Unsupported\n");
         }
+        free(ctx);
     }
 
     fprintf(stderr, "\n");
 }
+
+/// Number of widths in all bins of a histogram
+static unsigned histogram_total(histogram_t const *hist)
+{
+    unsigned count = 0;
+    for (unsigned n = 0; n < hist->bins_count; ++n) {
+        count += hist->bins[n].count;
+    }
+    return count;
+}
+
+/// Number of bins holding at least an eighth of len widths (two at least),
+/// the few widths of a sync, the packet gaps or the end gap carry no data.
+static unsigned histogram_data_bins(histogram_t const *hist, unsigned len)
+{
+    unsigned min_count = len / 8 > 2 ? len / 8 : 2;
+    unsigned bins      = 0;
+    for (unsigned n = 0; n < hist->bins_count; ++n) {
+        if (hist->bins[n].count >= min_count) {
+            bins++;
+        }
+    }
+    return bins;
+}
+
+/// Copy the bin ranges of a histogram, or a single range over all widths if
+/// some widths found no free bin.
+static unsigned timing_ranges(pulse_timing_range_t *ranges, histogram_t const *hist, pulse_data_t const *data, width_fn_t width, unsigned len)
+{
+    if (histogram_total(hist) == len) {
+        for (unsigned n = 0; n < hist->bins_count; ++n) {
+            ranges[n].min = hist->bins[n].min;
+            ranges[n].max = hist->bins[n].max;
+        }
+        return hist->bins_count;
+    }
+
+    ranges[0].min = INT_MAX;
+    ranges[0].max = INT_MIN;
+    for (unsigned n = 0; n < len; ++n) {
+        int w = width(data, n);
+        ranges[0].min = MIN(ranges[0].min, w);
+        ranges[0].max = MAX(ranges[0].max, w);
+    }
+    return 1;
+}
+
+void pulse_timing_analyze(pulse_timing_t *timing, pulse_data_t const *data)
+{
+    histogram_t hist_pulses = {0};
+    histogram_t hist_gaps   = {0};
+
+    histogram_sum(&hist_pulses, data, pulse_data_get_pulse, data->num_pulses, TOLERANCE);
+    histogram_sum(&hist_gaps, data, pulse_data_get_gap, data->num_pulses, TOLERANCE);
+    histogram_fuse_bins(&hist_pulses, TOLERANCE);
+    histogram_fuse_bins(&hist_gaps, TOLERANCE);
+
+    timing->pulse_count = timing_ranges(timing->pulses, &hist_pulses, data, pulse_data_get_pulse, data->num_pulses);
+    timing->gap_count   = timing_ranges(timing->gaps, &hist_gaps, data, pulse_data_get_gap, data->num_pulses);
+
+    // Data needs at least two widths, pulse widths for PWM and gap widths for
+    // PPM. A coding is only ruled out if the other one carries the data, a
+    // payload of identical bits has a single width in both. Uncertain if some
+    // widths were not binned.
+    timing->codings = PULSE_CODING_ALL;
+    if (data->num_pulses < 2
+            || histogram_total(&hist_pulses) != data->num_pulses
+            || histogram_total(&hist_gaps) != data->num_pulses) {
+        return;
+    }
+    unsigned pulse_bins = histogram_data_bins(&hist_pulses, data->num_pulses);
+    unsigned gap_bins   = histogram_data_bins(&hist_gaps, data->num_pulses);
+    if (pulse_bins <= 1 && gap_bins >= 2) {
+        timing->codings &= ~PULSE_CODING_PWM;
+    }
+    if (gap_bins <= 1 && pulse_bins >= 2) {
+        timing->codings &= ~PULSE_CODING_PPM;
+    }
+}
+
+int pulse_timing_separable(float short_width, float long_width)
+{
+    float lower = short_width < long_width ? short_width : long_width;
+    float upper = short_width < long_width ? long_width : short_width;
+    // twice the bin tolerance leaves room for the jitter of both widths
+    return lower > 0 && upper - lower >= 2 * TOLERANCE * upper;
+}
+
+/// Check if any range overlaps the open interval (lower, upper).
+static int timing_ranges_overlap(pulse_timing_range_t const *ranges, unsigned count, int lower, int upper)
+{
+    for (unsigned n = 0; n < count; ++n) {
+        if (ranges[n].max > lower && ranges[n].min < upper) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int pulse_timing_has_pulse(pulse_timing_t const *timing, int lower, int upper)
+{
+    return timing_ranges_overlap(timing->pulses, timing->pulse_count, lower, upper);
+}
+
+int pulse_timing_has_gap(pulse_timing_t const *timing, int lower, int upper)
+{
+    return timing_ranges_overlap(timing->gaps, timing->gap_count, lower, upper);
+}
+
+#ifdef _TEST
+
+#define ASSERT(expr) \
+    do { \
+        if (expr) { \
+            ++passed; \
+        } else { \
+            ++failed; \
+            fprintf(stderr, "FAIL: line %d: %s\n", __LINE__, #expr); \
+        } \
+    } while (0)
+
+/// A PWM train of the 32 bits, MSB first, with some jitter.
+static void pwm_train(pulse_data_t *data, uint32_t bits, int s_short, int s_long, int s_gap)
+{
+    pulse_data_clear(data);
+    for (unsigned i = 0; i < 32; ++i) {
+        int jitter = (int)(i % 3) - 1;
+        pulse_data_set_pulse(data, i, (bits >> (31 - i) & 1 ? s_long : s_short) + jitter * 8);
+        pulse_data_set_gap(data, i, s_gap + jitter * 8);
+    }
+    data->num_pulses = 32;
+}
+
+/// A PPM train of the 32 bits, MSB first, with some jitter.
+static void ppm_train(pulse_data_t *data, uint32_t bits, int s_pulse, int s_short, int s_long)
+{
+    pulse_data_clear(data);
+    for (unsigned i = 0; i < 32; ++i) {
+        int jitter = (int)(i % 3) - 1;
+        pulse_data_set_pulse(data, i, s_pulse + jitter * 8);
+        pulse_data_set_gap(data, i, (bits >> (31 - i) & 1 ? s_long : s_short) + jitter * 8);
+    }
+    data->num_pulses = 32;
+}
+
+int main(void)
+{
+    unsigned passed = 0;
+    unsigned failed = 0;
+
+    fprintf(stderr, "pulse_analyzer:: test\n");
+
+    static pulse_data_t data;
+    pulse_timing_t timing;
+
+    fprintf(stderr, "TEST: pulse_analyzer:: Separable widths\n");
+    ASSERT(pulse_timing_separable(300, 900));
+    ASSERT(pulse_timing_separable(900, 300));
+    ASSERT(!pulse_timing_separable(400, 480));
+    ASSERT(!pulse_timing_separable(400, 600));
+    ASSERT(!pulse_timing_separable(0, 600));
+
+    fprintf(stderr, "TEST: pulse_analyzer:: PWM train with distinct widths\n");
+    pwm_train(&data, 0x5555aaaa, 300, 900, 600);
+    pulse_timing_analyze(&timing, &data);
+    ASSERT(timing.codings & PULSE_CODING_PWM);
+    ASSERT(!(timing.codings & PULSE_CODING_PPM));
+
+    fprintf(stderr, "TEST: pulse_analyzer:: PPM train\n");
+    ppm_train(&data, 0x5555aaaa, 300, 600, 1200);
+    pulse_timing_analyze(&timing, &data);
+    ASSERT(timing.codings & PULSE_CODING_PPM);
+    ASSERT(!(timing.codings & PULSE_CODING_PWM));
+
+    fprintf(stderr, "TEST: pulse_analyzer:: PWM train with an all zero payload\n");
+    // four repeats of 8 bits, the packet gaps are too few to carry PPM data
+    pwm_train(&data, 0, 300, 900, 600);
+    pulse_data_set_gap(&data, 7, 5000);
+    pulse_data_set_gap(&data, 15, 5000);
+    pulse_data_set_gap(&data, 23, 5000);
+    pulse_timing_analyze(&timing, &data);
+    ASSERT(timing.pulse_count == 1);
+    ASSERT(timing.codings & PULSE_CODING_PWM);
+    ASSERT(timing.codings & PULSE_CODING_PPM);
+
+    fprintf(stderr, "TEST: pulse_analyzer:: PWM train with close widths\n");
+    // both widths share one bin, like a payload of identical bits
+    pwm_train(&data, 0x5555aaaa, 400, 480, 600);
+    pulse_timing_analyze(&timing, &data);
+    ASSERT(timing.pulse_count == 1);
+    ASSERT(timing.codings & PULSE_CODING_PWM);
+    ASSERT(pulse_timing_has_pulse(&timing, 400 - 30, 400 + 30));
+    ASSERT(pulse_timing_has_pulse(&timing, 480 - 30, 480 + 30));
+    // a PPM train rules out PWM, a decoder with these widths must still run
+    ppm_train(&data, 0x5555aaaa, 440, 600, 1200);
+    pulse_timing_analyze(&timing, &data);
+    ASSERT(!(timing.codings & PULSE_CODING_PWM));
+    ASSERT(!pulse_timing_separable(400, 480));
+
+    fprintf(stderr, "pulse_analyzer:: test (%u/%u) passed, (%u) failed.\n", passed, passed + failed, failed);
+
+    return failed;
+}
+
+#endif /* _TEST */
@@ -27,15 +27,44 @@ void pulse_data_shift(pulse_data_t *data)
     int offs = PD_MAX_PULSES / 2; // shift out half the data
     memmove(data->pulse, &data->pulse[offs], (PD_MAX_PULSES - offs) * sizeof(*data->pulse));
     memmove(data->gap, &data->gap[offs], (PD_MAX_PULSES - offs) * sizeof(*data->gap));
+    // re-index the escaped widths, dropping those shifted out
+    unsigned num_long = 0;
+    for (unsigned i = 0; i < data->num_long; ++i) {
+        unsigned n = data->long_index[i] & ~PD_LONG_GAP;
+        if (n >= (unsigned)offs) {
+            data->long_index[num_long] = data->long_index[i] - offs;
+            data->long_width[num_long] = data->long_width[i];
+            num_long++;
+        }
+    }
+    data->num_long = num_long;
     data->num_pulses -= offs;
     data->offset += offs;
 }
 
+unsigned long pulse_data_split(pulse_data_t *data, pulse_data_t *rest, unsigned count, unsigned total)
+{
+    unsigned long duration = 0;
+    for (unsigned i = count; i < total; ++i) {
+        unsigned pulse = pulse_data_get_pulse(data, i);
+        unsigned gap   = pulse_data_get_gap(data, i);
+        pulse_data_set_pulse(rest, i - count, pulse);
+        pulse_data_set_gap(rest, i - count, gap);
+        duration += pulse + gap;
+    }
+    // escaped widths of the moved pulses are left behind unused
+    memset(&data->pulse[count], 0, (total - count) * sizeof(*data->pulse));
+    memset(&data->gap[count], 0, (total - count) * sizeof(*data->gap));
+    return duration;
+}
+
 void pulse_data_print(pulse_data_t const *data)
 {
     fprintf(stderr, "Pulse data: %u pulses\n", data->num_pulses);
     for (unsigned n = 0; n < data->num_pulses; ++n) {
-        fprintf(stderr, "[%3u] Pulse: %4d, Gap: %4d, Period: %4d\n", n, data->pulse[n], data->gap[n], data->pulse[n] + data->gap[n]);
+        int pulse = pulse_data_get_pulse(data, n);
+        int gap   = pulse_data_get_gap(data, n);
+        fprintf(stderr, "[%3u] Pulse: %4d, Gap: %4d, Period: %4d\n", n, pulse, gap, pulse + gap);
     }
 }
 
@@ -57,10 +86,12 @@ void pulse_data_dump_raw(uint8_t *buf, unsigned len, uint64_t buf_offset, pulse_
 {
     int64_t pos = data->offset - buf_offset;
     for (unsigned n = 0; n < data->num_pulses; ++n) {
-        bounded_memset(buf, 0x01 | bits, len, pos, data->pulse[n]);
-        pos += data->pulse[n];
-        bounded_memset(buf, 0x01, len, pos, data->gap[n]);
-        pos += data->gap[n];
+        int pulse = pulse_data_get_pulse(data, n);
+        int gap   = pulse_data_get_gap(data, n);
+        bounded_memset(buf, 0x01 | bits, len, pos, pulse);
+        pos += pulse;
+        bounded_memset(buf, 0x01, len, pos, gap);
+        pos += gap;
     }
 }
 
@@ -106,9 +137,9 @@ void pulse_data_print_vcd(FILE *file, pulse_data_t const *data, int ch_id)
             chk_ret(fprintf(file, "#%.f 1/ 1%c\n", pos * scale, ch_id));
         else
             chk_ret(fprintf(file, "#%.f 1%c\n", pos * scale, ch_id));
-        pos += data->pulse[n];
+        pos += pulse_data_get_pulse(data, n);
         chk_ret(fprintf(file, "#%.f 0%c\n", pos * scale, ch_id));
-        pos += data->gap[n];
+        pos += pulse_data_get_gap(data, n);
     }
     if (data->num_pulses > 0)
         chk_ret(fprintf(file, "#%.f 0/\n", pos * scale));
@@ -152,8 +183,8 @@ void pulse_data_load(FILE *file, pulse_data_t *data, uint32_t sample_rate)
         p          = endptr + 1;
         long space = strtol(p, &endptr, 10);
         // fprintf(stderr, "read: mark %ld space %ld\n", mark, space);
-        data->pulse[i] = (int)(to_sample * mark);
-        data->gap[i++] = (int)(to_sample * space);
+        pulse_data_set_pulse(data, i, (unsigned)(to_sample * mark));
+        pulse_data_set_gap(data, i++, (unsigned)(to_sample * space));
     }
     // fprintf(stderr, "read %d pulses\n", i);
     data->num_pulses = i;
@@ -194,7 +225,7 @@ void pulse_data_dump(FILE *file, pulse_data_t const *data)
 
     double to_us = 1e6 / data->sample_rate;
     for (unsigned i = 0; i < data->num_pulses; ++i) {
-        chk_ret(fprintf(file, "%.0f %.0f\n", data->pulse[i] * to_us, data->gap[i] * to_us));
+        chk_ret(fprintf(file, "%.0f %.0f\n", pulse_data_get_pulse(data, i) * to_us, pulse_data_get_gap(data, i) * to_us));
     }
     chk_ret(fprintf(file, ";end\n"));
 }
@@ -204,8 +235,8 @@ data_t *pulse_data_print_data(pulse_data_t const *data)
     int pulses[2 * PD_MAX_PULSES];
     double to_us = 1e6 / data->sample_rate;
     for (unsigned i = 0; i < data->num_pulses; ++i) {
-        pulses[i * 2 + 0] = data->pulse[i] * to_us;
-        pulses[i * 2 + 1] = data->gap[i] * to_us;
+        pulses[i * 2 + 0] = pulse_data_get_pulse(data, i) * to_us;
+        pulses[i * 2 + 1] = pulse_data_get_gap(data, i) * to_us;
     }
 
     /* clang-format off */
@@ -225,3 +256,74 @@ data_t *pulse_data_print_data(pulse_data_t const *data)
             NULL);
     /* clang-format on */
 }
+
+#ifdef _TEST
+
+#define ASSERT(expr) \
+    do { \
+        if (expr) { \
+            ++passed; \
+        } else { \
+            ++failed; \
+            fprintf(stderr, "FAIL: line %d: %s\n", __LINE__, #expr); \
+        } \
+    } while (0)
+
+int main(void)
+{
+    unsigned passed = 0;
+    unsigned failed = 0;
+
+    fprintf(stderr, "pulse_data:: test\n");
+
+    static pulse_data_t data;
+    static pulse_data_t rest;
+
+    fprintf(stderr, "TEST: pulse_data:: Split a capture with a short tail\n");
+    // 20 pulses of a packet, the packet gap, and 3 pulses of a tail still being captured
+    unsigned long packet = 0;
+    for (unsigned i = 0; i < 20; ++i) {
+        pulse_data_set_pulse(&data, i, 500);
+        pulse_data_set_gap(&data, i, i == 19 ? 70000 : 1000);
+        packet += 500 + (i == 19 ? 70000 : 1000);
+    }
+    for (unsigned i = 20; i < 23; ++i) {
+        pulse_data_set_pulse(&data, i, 400);
+        pulse_data_set_gap(&data, i, 800);
+    }
+    unsigned long start = 1000000; // first edge of the capture
+    unsigned long edge  = start + packet + 3 * (400 + 800); // edge ending the last gap
+    unsigned long tail  = pulse_data_split(&data, &rest, 20, 23);
+    ASSERT(tail == 3 * (400 + 800));
+    // the tail is measured from its own first edge, not from the capture
+    ASSERT(edge - tail == start + packet);
+    // so a tail shorter than the OOK MINIMUM_SIGNAL_LENGTH of 40 ms is rejected
+    ASSERT(tail < 40000);
+    ASSERT(edge - start > 40000);
+    ASSERT(pulse_data_get_pulse(&rest, 0) == 400);
+    ASSERT(pulse_data_get_gap(&rest, 2) == 800);
+    ASSERT(pulse_data_get_gap(&data, 19) == 70000);
+    ASSERT(data.pulse[20] == 0 && data.gap[22] == 0);
+
+    fprintf(stderr, "TEST: pulse_data:: Split without a tail\n");
+    pulse_data_clear(&rest);
+    ASSERT(pulse_data_split(&data, &rest, 20, 20) == 0);
+    ASSERT(rest.pulse[0] == 0);
+
+    fprintf(stderr, "TEST: pulse_data:: Split carries long widths\n");
+    pulse_data_clear(&data);
+    pulse_data_clear(&rest);
+    pulse_data_set_pulse(&data, 0, 500);
+    pulse_data_set_gap(&data, 0, 100000);
+    pulse_data_set_pulse(&data, 1, 500);
+    pulse_data_set_gap(&data, 1, 90000);
+    ASSERT(pulse_data_split(&data, &rest, 1, 2) == 90500);
+    ASSERT(pulse_data_get_gap(&rest, 0) == 90000);
+    ASSERT(pulse_data_get_gap(&data, 0) == 100000);
+
+    fprintf(stderr, "pulse_data:: test (%u/%u) passed, (%u) failed.\n", passed, passed + failed, failed);
+
+    return failed;
+}
+
+#endif /* _TEST */
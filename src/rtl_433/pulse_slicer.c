@@ -26,22 +26,23 @@
 #include "bit_util.h"
 #include "c_util.h"
 
-bitbuffer_t bits = {0};
-
-static int account_event(r_device* device, bitbuffer_t* bits, char const* demod_name) {
-  // run decoder
+static int account_decode(r_device_state* state, bitbuffer_t* bits, char const* demod_name) {
+  r_device const* device = state->device;
+  // run decoder, the decoders never write to their (usually const) r_device
   int ret = 0;
   if (device->decode_fn) {
-    ret = device->decode_fn(device, bits);
+    // bitbuffer_clear() zeroes up to the widest row, a decoder writing past
+    // bits_per_row calls bitbuffer_touch() itself
+    ret = device->decode_fn((r_device*)device, bits);
   }
 
   // statistics accounting
-  device->decode_events += 1;
+  state->decode_events += 1;
   if (ret > 0) {
-    device->decode_ok += 1;
-    device->decode_messages += ret;
+    state->decode_ok += 1;
+    state->decode_messages += ret;
   } else if (ret >= DECODE_FAIL_SANITY) {
-    device->decode_fails[-ret] += 1;
+    state->decode_fails[-ret] += 1;
     ret = 0;
   } else {
     print_logf(LOG_ERROR, demod_name, "Decoder \"%s\" gave invalid return value %d: notify maintainer", device->name, ret);
@@ -56,15 +57,36 @@ static int account_event(r_device* device, bitbuffer_t* bits, char const* demod_
     }
   }
 
-  if (!device->decode_fn || (device->verbose && ret > 0) || (device->verbose > 1 && max_bits > 16) || (device->verbose > 2)) {
-    decoder_log_bitbuffer(device, ret > 0 ? 1 : 2, demod_name, bits, device->name);
+  if (!device->decode_fn || (state->verbose && ret > 0) || (state->verbose > 1 && max_bits > 16) || (state->verbose > 2)) {
+    decoder_log_bitbuffer((r_device*)device, ret > 0 ? 1 : 2, demod_name, bits, device->name);
   }
 
   return ret;
 }
 
-int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
-  float samples_per_us = pulses->sample_rate / 1.0e6;
+static int account_event(pulse_slicer_ctx_t* ctx, r_device_state* state, char const* demod_name) {
+  // preamble searches repeated on a row are looked up, see bitbuffer_search()
+  bitbuffer_share_preambles(&ctx->bits, &ctx->preambles);
+  int ret = 0;
+  if (!ctx->group) {
+    ret = account_decode(state, &ctx->bits, demod_name);
+  } else {
+    // decoders may modify the bitbuffer, all but the last get a copy of the unchanged slice
+    for (unsigned i = 0; i < ctx->group_len; ++i) {
+      bitbuffer_t* bits = &ctx->bits;
+      if (i + 1 < ctx->group_len) {
+        bitbuffer_copy(&ctx->copy, &ctx->bits);
+        bits = &ctx->copy;
+      }
+      ret += account_decode(ctx->group[i], bits, demod_name);
+    }
+  }
+  ctx->bits.preambles = NULL;
+  return ret;
+}
+
+void pulse_slicer_timing_init(pulse_slicer_timing_t* timing, r_device const* device, uint32_t sample_rate) {
+  float samples_per_us = sample_rate / 1.0e6;
   int s_short = device->short_width * samples_per_us;
   int s_long = device->long_width * samples_per_us;
   int s_reset = device->reset_limit * samples_per_us;
@@ -72,19 +94,224 @@ int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
   int s_sync = device->sync_width * samples_per_us;
   int s_tolerance = device->tolerance * samples_per_us;
 
+  timing->sample_rate = sample_rate;
+  timing->too_low = (device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0);
+  timing->s_short = s_short;
+  timing->s_long = s_long;
+  timing->s_reset = s_reset;
+  timing->s_gap = s_gap;
+  timing->s_sync = s_sync;
+  timing->s_tolerance = s_tolerance;
+
+  // precision reciprocals, widths may be fractional samples
+  timing->r_short = device->short_width > 0.0 ? (int64_t)ceil(4294967296.0 / (device->short_width * samples_per_us)) : 0;
+  timing->r_long = device->long_width > 0.0 ? (int64_t)ceil(4294967296.0 / (device->long_width * samples_per_us)) : 0;
+
+  // PPM gaps, lower and upper bounds (non inclusive)
+  pulse_slicer_bounds_t* ppm = &timing->ppm;
+  ppm->sync_l = 0;
+  ppm->sync_u = 0;
+  if (s_tolerance > 0) {
+    // precise
+    ppm->zero_l = s_short - s_tolerance;
+    ppm->zero_u = s_short + s_tolerance;
+    ppm->one_l = s_long - s_tolerance;
+    ppm->one_u = s_long + s_tolerance;
+    if (s_sync > 0) {
+      ppm->sync_l = s_sync - s_tolerance;
+      ppm->sync_u = s_sync + s_tolerance;
+    }
+  } else {
+    // no sync, short=0, long=1
+    ppm->zero_l = 0;
+    ppm->zero_u = (s_short + s_long) / 2 + 1;
+    ppm->one_l = ppm->zero_u - 1;
+    ppm->one_u = s_gap ? s_gap : s_reset;
+  }
+
+  // PWM pulses, lower and upper bounds (non inclusive)
+//  if (s_tolerance <= 0) // From https://github.com/NorthernMan54/rtl_433_ESP/pull/65
+//    s_tolerance = s_long / 4; // default tolerance is +-25% of a bit period
+  pulse_slicer_bounds_t* pwm = &timing->pwm;
+  pwm->sync_l = 0;
+  pwm->sync_u = 0;
+  if (s_tolerance > 0) {
+    // precise
+    pwm->one_l = s_short - s_tolerance;
+    pwm->one_u = s_short + s_tolerance;
+    pwm->zero_l = s_long - s_tolerance;
+    pwm->zero_u = s_long + s_tolerance;
+    if (s_sync > 0) {
+      pwm->sync_l = s_sync - s_tolerance;
+      pwm->sync_u = s_sync + s_tolerance;
+    }
+  } else if (s_sync <= 0) {
+    // no sync, short=1, long=0
+    pwm->one_l = 0;
+    pwm->one_u = (s_short + s_long) / 2 + 1;
+    pwm->zero_l = pwm->one_u - 1;
+    pwm->zero_u = INT_MAX;
+  } else if (s_sync < s_short) {
+    // short=sync, middle=1, long=0
+    pwm->sync_l = 0;
+    pwm->sync_u = (s_sync + s_short) / 2 + 1;
+    pwm->one_l = pwm->sync_u - 1;
+    pwm->one_u = (s_short + s_long) / 2 + 1;
+    pwm->zero_l = pwm->one_u - 1;
+    pwm->zero_u = INT_MAX;
+  } else if (s_sync < s_long) {
+    // short=1, middle=sync, long=0
+    pwm->one_l = 0;
+    pwm->one_u = (s_short + s_sync) / 2 + 1;
+    pwm->sync_l = pwm->one_u - 1;
+    pwm->sync_u = (s_sync + s_long) / 2 + 1;
+    pwm->zero_l = pwm->sync_u - 1;
+    pwm->zero_u = INT_MAX;
+  } else {
+    // short=1, middle=0, long=sync
+    pwm->one_l = 0;
+    pwm->one_u = (s_short + s_long) / 2 + 1;
+    pwm->zero_l = pwm->one_u - 1;
+    pwm->zero_u = (s_long + s_sync) / 2 + 1;
+    pwm->sync_l = pwm->zero_u - 1;
+    pwm->sync_u = INT_MAX;
+  }
+}
+
+/// Timings of a device for the sample rate of the pulses, from the cache
+/// filled in at registration if the sample rate matches.
+static pulse_slicer_timing_t const* slicer_timing(pulse_data_t const* pulses, r_device_state* state, pulse_slicer_timing_t* scratch) {
+  pulse_slicer_timing_t* timing = state->slicer_timing;
+  if (timing && timing->sample_rate == pulses->sample_rate) {
+    return timing;
+  }
+  if (!timing) {
+    timing = scratch; // unregistered device, e.g. from the pulse analyzer
+  }
+  pulse_slicer_timing_init(timing, state->device, pulses->sample_rate);
+  return timing;
+}
+
+/// Q32 fixed point reciprocal of a width measured over count bits,
+/// rounded up so that exact half bits round up in slicer_bits().
+static inline int64_t slicer_reciprocal(int count, int width) {
+  return width > 0 ? (((int64_t)count << 32) + width - 1) / width : 0;
+}
+
+/// Number of bits in a width for a Q32 reciprocal of the bit width, rounded.
+static inline int slicer_bits(int width, int64_t reciprocal) {
+  return (int)(((int64_t)width * reciprocal + ((int64_t)1 << 31)) >> 32);
+}
+
+/// Bit width in samples for a Q32 reciprocal, for logging only.
+static inline float slicer_width(int64_t reciprocal) {
+  return reciprocal ? 4294967296.0f / reciprocal : 0;
+}
+
+/// Packed symbol of a width and the gap after it, see quantize_widths().
+enum slicer_symbol {
+  SYMBOL_ZERO = 0,   ///< width within the zero bounds
+  SYMBOL_ONE = 1,    ///< width within the one bounds
+  SYMBOL_SYNC = 2,   ///< width within the sync bounds
+  SYMBOL_SHORT = 3,  ///< width not above the lower one bound
+  SYMBOL_NONE = 4,   ///< width outside all bounds
+  SYMBOL_MASK = 7,
+  SYMBOL_ROW = 8,    ///< gap above the row limit
+  SYMBOL_RESET = 16, ///< gap above the reset limit
+};
+
+/// Width range of an open interval as an offset and length, empty if l >= u - 1.
+typedef struct {
+  int start;
+  unsigned len;
+} symbol_range_t;
+
+static inline symbol_range_t symbol_range(int l, int u) {
+  symbol_range_t r = {l + 1, u > l + 1 ? (unsigned)u - (unsigned)(l + 1) : 0};
+  return r;
+}
+
+static inline unsigned in_range(int width, symbol_range_t r) {
+  return (unsigned)(width - r.start) < r.len;
+}
+
+/// Symbol of a width, zero or one taking precedence on overlapping bounds.
+static inline unsigned quantize_width(int width, int gap, symbol_range_t zero, symbol_range_t one, symbol_range_t sync, int zero_first, int row_limit, int reset_limit) {
+  unsigned symbol = width < one.start ? SYMBOL_SHORT : SYMBOL_NONE;
+  symbol = in_range(width, sync) ? SYMBOL_SYNC : symbol;
+  symbol = in_range(width, zero_first ? one : zero) ? (zero_first ? SYMBOL_ONE : SYMBOL_ZERO) : symbol;
+  symbol = in_range(width, zero_first ? zero : one) ? (zero_first ? SYMBOL_ZERO : SYMBOL_ONE) : symbol;
+  return symbol | (gap > row_limit) * SYMBOL_ROW | (gap > reset_limit) * SYMBOL_RESET;
+}
+
+/// Quantize the pulse or gap widths of a train into packed symbols in one pass.
+///
+/// The loop is branchless (selects only), widths escaped to the long width
+/// table are fixed up afterwards.
+static void quantize_widths(uint8_t* restrict symbols, pulse_data_t const* pulses, int use_gaps, pulse_slicer_bounds_t const* b, int row_limit, int reset_limit) {
+  unsigned const num_pulses = pulses->num_pulses;
+  uint16_t const* restrict widths = use_gaps ? pulses->gap : pulses->pulse;
+  uint16_t const* restrict gaps = pulses->gap;
+  symbol_range_t const zero = symbol_range(b->zero_l, b->zero_u);
+  symbol_range_t const one = symbol_range(b->one_l, b->one_u);
+  symbol_range_t const sync = symbol_range(b->sync_l, b->sync_u);
+
+  if (use_gaps) {
+    for (unsigned n = 0; n < num_pulses; ++n) {
+      symbols[n] = quantize_width(widths[n], gaps[n], zero, one, sync, 1, row_limit, reset_limit);
+    }
+  } else {
+    for (unsigned n = 0; n < num_pulses; ++n) {
+      symbols[n] = quantize_width(widths[n], gaps[n], zero, one, sync, 0, row_limit, reset_limit);
+    }
+  }
+
+  for (unsigned i = 0; i < pulses->num_long; ++i) {
+    unsigned n = pulses->long_index[i] & ~PD_LONG_GAP;
+    if (n < num_pulses) {
+      int width = use_gaps ? pulse_data_get_gap(pulses, n) : pulse_data_get_pulse(pulses, n);
+      symbols[n] = quantize_width(width, pulse_data_get_gap(pulses, n), zero, one, sync, use_gaps, row_limit, reset_limit);
+    }
+  }
+}
+
+/// Add the run of plain data symbols (no sync, row or reset) from n up to end,
+/// returns the index after the run.
+static inline unsigned add_symbol_run(bitbuffer_t* bits, uint8_t const* symbols, unsigned n, unsigned end) {
+  while (n < end && symbols[n] <= SYMBOL_ONE) {
+    uint32_t word = 0;
+    unsigned count = 0;
+    for (; count < 32 && n < end && symbols[n] <= SYMBOL_ONE; ++count, ++n) {
+      word = word << 1 | symbols[n];
+    }
+    bitbuffer_add_bits(bits, word, count);
+  }
+  return n;
+}
+
+int pulse_slicer_pcm(pulse_slicer_ctx_t* ctx, pulse_data_t const* pulses, r_device_state* state) {
+  r_device const* device = state->device;
+  pulse_slicer_timing_t scratch;
+  pulse_slicer_timing_t const* t = slicer_timing(pulses, state, &scratch);
+  int const s_short = t->s_short;
+  int const s_long = t->s_long;
+  int const s_reset = t->s_reset;
+  int const s_gap = t->s_gap;
+  int const s_tolerance = t->s_tolerance;
+
   // check for rounding to zero
-  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
-    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
+  if (t->too_low) {
+    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", state->protocol_num, device->name);
     return 0;
   }
 
   // precision reciprocals
-  float f_short = device->short_width > 0.0 ? 1.0 / (device->short_width * samples_per_us) : 0;
-  float f_long = device->long_width > 0.0 ? 1.0 / (device->long_width * samples_per_us) : 0;
+  int64_t r_short = t->r_short;
+  int64_t r_long = t->r_long;
 
   int events = 0;
-  // bitbuffer_t bits = {0};
-  bitbuffer_clear(&bits);
+  bitbuffer_t* bits = &ctx->bits;
+  bitbuffer_clear(bits);
 
   int const gap_limit = s_gap ? s_gap : s_reset;
   int const max_zeros = gap_limit / s_long;
@@ -97,23 +324,23 @@ int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
     int swidth = 0;
     int lwidth = 0;
     int count = 0;
-    while (n < pulses->num_pulses && pulses->pulse[n] >= s_short - s_tolerance && pulses->pulse[n] <= s_short + s_tolerance && pulses->pulse[n] + pulses->gap[n] >= s_long - s_tolerance && pulses->pulse[n] + pulses->gap[n] <= s_long + s_tolerance) {
-      swidth += pulses->pulse[n];
-      lwidth += pulses->pulse[n] + pulses->gap[n];
+    while (n < pulses->num_pulses && pulse_data_get_pulse(pulses, n) >= s_short - s_tolerance && pulse_data_get_pulse(pulses, n) <= s_short + s_tolerance && pulse_data_get_pulse(pulses, n) + pulse_data_get_gap(pulses, n) >= s_long - s_tolerance && pulse_data_get_pulse(pulses, n) + pulse_data_get_gap(pulses, n) <= s_long + s_tolerance) {
+      swidth += pulse_data_get_pulse(pulses, n);
+      lwidth += pulse_data_get_pulse(pulses, n) + pulse_data_get_gap(pulses, n);
       count += 1;
       n++;
     }
     // require at least min_count bits preamble
     if (count >= min_count) {
-      f_long = (float)count / lwidth;
-      f_short = (float)count / swidth;
+      r_long = slicer_reciprocal(count, lwidth);
+      r_short = slicer_reciprocal(count, swidth);
       min_count = count;
       preamble_len = count;
-      if (device->verbose > 1) {
+      if (state->verbose > 1) {
         float to_us = 1e6 / pulses->sample_rate;
         print_logf(LOG_INFO, __func__, "Exact bit width (in us) is %.2f vs %.2f (pulse width %.2f vs %.2f), %d bit preamble",
-                   to_us / f_long, to_us * s_long,
-                   to_us / f_short, to_us * s_short, count);
+                   to_us * slicer_width(r_long), to_us * s_long,
+                   to_us * slicer_width(r_short), to_us * s_short, count);
       }
     }
   }
@@ -122,41 +349,41 @@ int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
   int rzl_width = 0;
   int rz_count = 0;
   for (unsigned n = 0; preamble_len == 0 && s_short != s_long && n < pulses->num_pulses; ++n) {
-    if (pulses->pulse[n] >= s_short - s_tolerance && pulses->pulse[n] <= s_short + s_tolerance && pulses->pulse[n] + pulses->gap[n] >= s_long - s_tolerance && pulses->pulse[n] + pulses->gap[n] <= s_long + s_tolerance) {
-      rzs_width += pulses->pulse[n];
-      rzl_width += pulses->pulse[n] + pulses->gap[n];
+    if (pulse_data_get_pulse(pulses, n) >= s_short - s_tolerance && pulse_data_get_pulse(pulses, n) <= s_short + s_tolerance && pulse_data_get_pulse(pulses, n) + pulse_data_get_gap(pulses, n) >= s_long - s_tolerance && pulse_data_get_pulse(pulses, n) + pulse_data_get_gap(pulses, n) <= s_long + s_tolerance) {
+      rzs_width += pulse_data_get_pulse(pulses, n);
+      rzl_width += pulse_data_get_pulse(pulses, n) + pulse_data_get_gap(pulses, n);
       rz_count += 1;
     }
   }
   // require at least 8 bits measured
   if (rz_count > 8) {
-    f_long = (float)rz_count / rzl_width;
-    f_short = (float)rz_count / rzs_width;
-    if (device->verbose > 1) {
+    r_long = slicer_reciprocal(rz_count, rzl_width);
+    r_short = slicer_reciprocal(rz_count, rzs_width);
+    if (state->verbose > 1) {
       float to_us = 1e6 / pulses->sample_rate;
       print_logf(LOG_INFO, __func__, "Exact bit width (in us) is %.2f vs %.2f (pulse width %.2f vs %.2f), %d bit measured",
-                 to_us / f_long, to_us * s_long,
-                 to_us / f_short, to_us * s_short, rz_count);
+                 to_us * slicer_width(r_long), to_us * s_long,
+                 to_us * slicer_width(r_short), to_us * s_short, rz_count);
     }
   }
   // NRZ
   for (unsigned n = 0; s_short == s_long && n < pulses->num_pulses; ++n) {
     int width = 0;
     int count = 0;
-    while (n < pulses->num_pulses && (int)(pulses->pulse[n] * f_short + 0.5) == 1 && (int)(pulses->gap[n] * f_long + 0.5) == 1) {
-      width += pulses->pulse[n] + pulses->gap[n];
+    while (n < pulses->num_pulses && slicer_bits(pulse_data_get_pulse(pulses, n), r_short) == 1 && slicer_bits(pulse_data_get_gap(pulses, n), r_long) == 1) {
+      width += pulse_data_get_pulse(pulses, n) + pulse_data_get_gap(pulses, n);
       count += 2;
       n++;
     }
     // require at least min_count full bits preamble
     if (count >= min_count) {
-      f_short = f_long = (float)count / width;
+      r_short = r_long = slicer_reciprocal(count, width);
       min_count = count;
       preamble_len = count;
-      if (device->verbose > 1) {
+      if (state->verbose > 1) {
         float to_us = 1e6 / pulses->sample_rate;
         print_logf(LOG_INFO, __func__, "Exact bit width (in us) is %.2f vs %.2f, %d bit preamble",
-                   to_us / f_short, to_us * s_short, count);
+                   to_us * slicer_width(r_short), to_us * s_short, count);
       }
     }
   }
@@ -164,313 +391,259 @@ int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
   int nrz_width = 0;
   int nrz_count = 0;
   for (unsigned n = 0; preamble_len == 0 && s_short == s_long && n < pulses->num_pulses; ++n) {
-    if (pulses->pulse[n] >= s_short - s_tolerance && pulses->pulse[n] <= s_short + s_tolerance) {
-      nrz_width += pulses->pulse[n];
+    if (pulse_data_get_pulse(pulses, n) >= s_short - s_tolerance && pulse_data_get_pulse(pulses, n) <= s_short + s_tolerance) {
+      nrz_width += pulse_data_get_pulse(pulses, n);
       nrz_count += 1;
     }
-    if (pulses->pulse[n] >= 2 * s_short - s_tolerance && pulses->pulse[n] <= 2 * s_short + s_tolerance) {
-      nrz_width += pulses->pulse[n];
+    if (pulse_data_get_pulse(pulses, n) >= 2 * s_short - s_tolerance && pulse_data_get_pulse(pulses, n) <= 2 * s_short + s_tolerance) {
+      nrz_width += pulse_data_get_pulse(pulses, n);
       nrz_count += 2;
     }
-    if (pulses->gap[n] >= s_long - s_tolerance && pulses->gap[n] <= s_long + s_tolerance) {
-      nrz_width += pulses->gap[n];
+    if (pulse_data_get_gap(pulses, n) >= s_long - s_tolerance && pulse_data_get_gap(pulses, n) <= s_long + s_tolerance) {
+      nrz_width += pulse_data_get_gap(pulses, n);
       nrz_count += 1;
     }
-    if (pulses->gap[n] >= 2 * s_long - s_tolerance && pulses->gap[n] <= 2 * s_long + s_tolerance) {
-      nrz_width += pulses->gap[n];
+    if (pulse_data_get_gap(pulses, n) >= 2 * s_long - s_tolerance && pulse_data_get_gap(pulses, n) <= 2 * s_long + s_tolerance) {
+      nrz_width += pulse_data_get_gap(pulses, n);
       nrz_count += 2;
     }
   }
   // require at least 10 bits measured
   if (nrz_count > 20) {
-    f_short = f_long = (float)nrz_count / nrz_width;
-    if (device->verbose > 1) {
+    r_short = r_long = slicer_reciprocal(nrz_count, nrz_width);
+    if (state->verbose > 1) {
       float to_us = 1e6 / pulses->sample_rate;
       print_logf(LOG_INFO, __func__, "%s: Exact bit width (in us) is %.2f vs %.2f, %d bit measured", device->name,
-                 to_us / f_short, to_us * s_short, nrz_count);
+                 to_us * slicer_width(r_short), to_us * s_short, nrz_count);
     }
   }
 
   for (unsigned n = 0; n < pulses->num_pulses; ++n) {
+    int const pulse = pulse_data_get_pulse(pulses, n);
+    int const gap = pulse_data_get_gap(pulses, n);
     // Determine number of high bit periods for NRZ coding, where bits may not be separated
-    int highs = (pulses->pulse[n]) * f_short + 0.5;
+    int highs = slicer_bits(pulse, r_short);
     // Determine number of low bit periods in current gap length (rounded)
     // for RZ subtract the nominal bit-gap
-    int lows = (pulses->gap[n] + s_short - s_long) * f_long + 0.5;
+    int lows = slicer_bits(gap + s_short - s_long, r_long);
 
     // Add run of ones (1 for RZ, many for NRZ)
     for (int i = 0; i < highs; ++i) {
-      bitbuffer_add_bit(&bits, 1);
+      bitbuffer_add_bit(bits, 1);
     }
     // Add run of zeros, handle possibly negative "lows" gracefully
     lows = MIN(lows, max_zeros); // Don't overflow at end of message
     for (int i = 0; i < lows; ++i) {
-      bitbuffer_add_bit(&bits, 0);
+      bitbuffer_add_bit(bits, 0);
     }
 
     // Validate data
     if ((s_short != s_long) // Only for RZ coding
-        && (abs(pulses->pulse[n] - s_short) > s_tolerance)) { // Pulse must be within tolerance
+        && (abs(pulse - s_short) > s_tolerance)) { // Pulse must be within tolerance
 
       // Data is corrupt
-      if (device->verbose > 3) {
+      if (state->verbose > 3) {
         print_logf(LOG_TRACE, __func__, "bitbuffer cleared at %u: pulse %d, gap %d, period %d",
-                   n, pulses->pulse[n], pulses->gap[n],
-                   pulses->pulse[n] + pulses->gap[n]);
+                   n, pulse, gap, pulse + gap);
       }
-      bitbuffer_clear(&bits);
+      bitbuffer_clear(bits);
     }
 
     // Check for new packet in multipacket
-    else if (pulses->gap[n] > gap_limit && pulses->gap[n] <= s_reset) {
-      bitbuffer_add_row(&bits);
+    else if (gap > gap_limit && gap <= s_reset) {
+      bitbuffer_add_row(bits);
     }
     // End of Message?
     if (((n == pulses->num_pulses - 1) // No more pulses? (FSK)
-         || (pulses->gap[n] > s_reset)) // Long silence (OOK)
-        && (bits.bits_per_row[0] > 0 || bits.num_rows > 1)) { // Only if data has been accumulated
+         || (gap > s_reset)) // Long silence (OOK)
+        && (bits->bits_per_row[0] > 0 || bits->num_rows > 1)) { // Only if data has been accumulated
 
-      events += account_event(device, &bits, __func__);
-      bitbuffer_clear(&bits);
+      events += account_event(ctx, state, __func__);
+      bitbuffer_clear(bits);
     }
   } // for
   return events;
 }
 
-int pulse_slicer_ppm(pulse_data_t const* pulses, r_device* device) {
-  float samples_per_us = pulses->sample_rate / 1.0e6;
-
-  int s_short = device->short_width * samples_per_us;
-  int s_long = device->long_width * samples_per_us;
-  int s_reset = device->reset_limit * samples_per_us;
-  int s_gap = device->gap_limit * samples_per_us;
-  int s_sync = device->sync_width * samples_per_us;
-  int s_tolerance = device->tolerance * samples_per_us;
+int pulse_slicer_ppm(pulse_slicer_ctx_t* ctx, pulse_data_t const* pulses, r_device_state* state) {
+  r_device const* device = state->device;
+  pulse_slicer_timing_t scratch;
+  pulse_slicer_timing_t const* t = slicer_timing(pulses, state, &scratch);
+  int const s_reset = t->s_reset;
 
   // check for rounding to zero
-  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
-    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
+  if (t->too_low) {
+    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", state->protocol_num, device->name);
     return 0;
   }
 
   int events = 0;
-  // bitbuffer_t bits = {0};
-  bitbuffer_clear(&bits);
-
-  // lower and upper bounds (non inclusive)
-  int zero_l, zero_u;
-  int one_l, one_u;
-  int sync_l = 0, sync_u = 0;
+  bitbuffer_t* bits = &ctx->bits;
+  bitbuffer_clear(bits);
 
-  if (s_tolerance > 0) {
-    // precise
-    zero_l = s_short - s_tolerance;
-    zero_u = s_short + s_tolerance;
-    one_l = s_long - s_tolerance;
-    one_u = s_long + s_tolerance;
-    if (s_sync > 0) {
-      sync_l = s_sync - s_tolerance;
-      sync_u = s_sync + s_tolerance;
-    }
-  } else {
-    // no sync, short=0, long=1
-    zero_l = 0;
-    zero_u = (s_short + s_long) / 2 + 1;
-    one_l = zero_u - 1;
-    one_u = s_gap ? s_gap : s_reset;
-  }
+  // symbols of the gaps, a gap not below the reset limit ends the message
+  uint8_t* symbols = ctx->symbols;
+  quantize_widths(symbols, pulses, 1, &t->ppm, INT_MAX, s_reset - 1);
 
   for (unsigned n = 0; n < pulses->num_pulses; ++n) {
-    if (pulses->gap[n] > zero_l && pulses->gap[n] < zero_u) {
-      // Short gap
-      bitbuffer_add_bit(&bits, 0);
-    } else if (pulses->gap[n] > one_l && pulses->gap[n] < one_u) {
-      // Long gap
-      bitbuffer_add_bit(&bits, 1);
-    } else if (pulses->gap[n] > sync_l && pulses->gap[n] < sync_u) {
-      // Sync gap
-      bitbuffer_add_sync(&bits);
-    }
-
-    // Check for new packet in multipacket
-    else if (pulses->gap[n] < s_reset) {
-      bitbuffer_add_row(&bits);
+    // runs of short and long gaps go in at once
+    n = add_symbol_run(bits, symbols, n, pulses->num_pulses - 1);
+    unsigned const symbol = symbols[n];
+    switch (symbol & SYMBOL_MASK) {
+      case SYMBOL_ZERO:
+        // Short gap
+        bitbuffer_add_bit(bits, 0);
+        break;
+      case SYMBOL_ONE:
+        // Long gap
+        bitbuffer_add_bit(bits, 1);
+        break;
+      case SYMBOL_SYNC:
+        // Sync gap
+        bitbuffer_add_sync(bits);
+        break;
+      default:
+        // Check for new packet in multipacket
+        if (!(symbol & SYMBOL_RESET)) {
+          bitbuffer_add_row(bits);
+        }
     }
     // End of Message?
     if (((n == pulses->num_pulses - 1) // No more pulses? (FSK)
-         || (pulses->gap[n] >= s_reset)) // Long silence (OOK)
-        && (bits.bits_per_row[0] > 0 || bits.num_rows > 1)) { // Only if data has been accumulated
+         || (symbol & SYMBOL_RESET)) // Long silence (OOK)
+        && (bits->bits_per_row[0] > 0 || bits->num_rows > 1)) { // Only if data has been accumulated
 
-      events += account_event(device, &bits, __func__);
-      bitbuffer_clear(&bits);
+      events += account_event(ctx, state, __func__);
+      bitbuffer_clear(bits);
     }
   } // for pulses
   return events;
 }
 
-int pulse_slicer_pwm(pulse_data_t const* pulses, r_device* device) {
-  float samples_per_us = pulses->sample_rate / 1.0e6;
-
-  int s_short = device->short_width * samples_per_us;
-  int s_long = device->long_width * samples_per_us;
-  int s_reset = device->reset_limit * samples_per_us;
-  int s_gap = device->gap_limit * samples_per_us;
-  int s_sync = device->sync_width * samples_per_us;
-  int s_tolerance = device->tolerance * samples_per_us;
-
-//  if (s_tolerance <= 0) // From https://github.com/NorthernMan54/rtl_433_ESP/pull/65
-//    s_tolerance = s_long / 4; // default tolerance is +-25% of a bit period
+int pulse_slicer_pwm(pulse_slicer_ctx_t* ctx, pulse_data_t const* pulses, r_device_state* state) {
+  r_device const* device = state->device;
+  pulse_slicer_timing_t scratch;
+  pulse_slicer_timing_t const* t = slicer_timing(pulses, state, &scratch);
+  int const s_reset = t->s_reset;
+  int const s_gap = t->s_gap;
 
   // check for rounding to zero
-  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
-    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
+  if (t->too_low) {
+    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", state->protocol_num, device->name);
     return 0;
   }
 
   int events = 0;
-  // bitbuffer_t bits = {0};
-  bitbuffer_clear(&bits);
+  bitbuffer_t* bits = &ctx->bits;
+  bitbuffer_clear(bits);
 
-  // lower and upper bounds (non inclusive)
-  int one_l, one_u;
-  int zero_l, zero_u;
-  int sync_l = 0, sync_u = 0;
-
-  if (s_tolerance > 0) {
-    // precise
-    one_l = s_short - s_tolerance;
-    one_u = s_short + s_tolerance;
-    zero_l = s_long - s_tolerance;
-    zero_u = s_long + s_tolerance;
-    if (s_sync > 0) {
-      sync_l = s_sync - s_tolerance;
-      sync_u = s_sync + s_tolerance;
-    }
-  } else if (s_sync <= 0) {
-    // no sync, short=1, long=0
-    one_l = 0;
-    one_u = (s_short + s_long) / 2 + 1;
-    zero_l = one_u - 1;
-    zero_u = INT_MAX;
-  } else if (s_sync < s_short) {
-    // short=sync, middle=1, long=0
-    sync_l = 0;
-    sync_u = (s_sync + s_short) / 2 + 1;
-    one_l = sync_u - 1;
-    one_u = (s_short + s_long) / 2 + 1;
-    zero_l = one_u - 1;
-    zero_u = INT_MAX;
-  } else if (s_sync < s_long) {
-    // short=1, middle=sync, long=0
-    one_l = 0;
-    one_u = (s_short + s_sync) / 2 + 1;
-    sync_l = one_u - 1;
-    sync_u = (s_sync + s_long) / 2 + 1;
-    zero_l = sync_u - 1;
-    zero_u = INT_MAX;
-  } else {
-    // short=1, middle=0, long=sync
-    one_l = 0;
-    one_u = (s_short + s_long) / 2 + 1;
-    zero_l = one_u - 1;
-    zero_u = (s_long + s_sync) / 2 + 1;
-    sync_l = zero_u - 1;
-    sync_u = INT_MAX;
-  }
+  // symbols of the pulses, with the gap after each
+  uint8_t* symbols = ctx->symbols;
+  quantize_widths(symbols, pulses, 0, &t->pwm, s_gap > 0 ? s_gap : INT_MAX, s_reset);
 
   for (unsigned n = 0; n < pulses->num_pulses; ++n) {
-    if (pulses->pulse[n] > one_l && pulses->pulse[n] < one_u) {
-      // 'Short' 1 pulse
-      bitbuffer_add_bit(&bits, 1);
-    } else if (pulses->pulse[n] > zero_l && pulses->pulse[n] < zero_u) {
-      // 'Long' 0 pulse
-      bitbuffer_add_bit(&bits, 0);
-    } else if (pulses->pulse[n] > sync_l && pulses->pulse[n] < sync_u) {
-      // Sync pulse
-      bitbuffer_add_sync(&bits);
-    } else if (pulses->pulse[n] <= one_l) {
-      // Ignore spurious short pulses
-    } else {
-      // Pulse outside specified timing
-      bitbuffer_add_row(&bits);
+    // runs of short and long pulses go in at once
+    n = add_symbol_run(bits, symbols, n, pulses->num_pulses - 1);
+    unsigned const symbol = symbols[n];
+    switch (symbol & SYMBOL_MASK) {
+      case SYMBOL_ONE:
+        // 'Short' 1 pulse
+        bitbuffer_add_bit(bits, 1);
+        break;
+      case SYMBOL_ZERO:
+        // 'Long' 0 pulse
+        bitbuffer_add_bit(bits, 0);
+        break;
+      case SYMBOL_SYNC:
+        // Sync pulse
+        bitbuffer_add_sync(bits);
+        break;
+      case SYMBOL_SHORT:
+        // Ignore spurious short pulses
+        break;
+      default:
+        // Pulse outside specified timing
+        bitbuffer_add_row(bits);
     }
 
     // End of Message?
     if (((n == pulses->num_pulses - 1) // No more pulses? (FSK)
-         || (pulses->gap[n] > s_reset)) // Long silence (OOK)
-        && (bits.num_rows > 0)) { // Only if data has been accumulated
-      events += account_event(device, &bits, __func__);
-      bitbuffer_clear(&bits);
-    } else if (s_gap > 0 && pulses->gap[n] > s_gap && bits.num_rows > 0 && bits.bits_per_row[bits.num_rows - 1] > 0) {
+         || (symbol & SYMBOL_RESET)) // Long silence (OOK)
+        && (bits->num_rows > 0)) { // Only if data has been accumulated
+      events += account_event(ctx, state, __func__);
+      bitbuffer_clear(bits);
+    } else if ((symbol & SYMBOL_ROW) && bits->num_rows > 0 && bits->bits_per_row[bits->num_rows - 1] > 0) {
       // New packet in multipacket
-      bitbuffer_add_row(&bits);
+      bitbuffer_add_row(bits);
     }
   }
   return events;
 }
 
-int pulse_slicer_manchester_zerobit(pulse_data_t const* pulses, r_device* device) {
-  float samples_per_us = pulses->sample_rate / 1.0e6;
-
-  int s_short = device->short_width * samples_per_us;
-  int s_long = device->long_width * samples_per_us;
-  int s_reset = device->reset_limit * samples_per_us;
-  int s_gap = device->gap_limit * samples_per_us;
-  int s_sync = device->sync_width * samples_per_us;
-  int s_tolerance = device->tolerance * samples_per_us;
+int pulse_slicer_manchester_zerobit(pulse_slicer_ctx_t* ctx, pulse_data_t const* pulses, r_device_state* state) {
+  r_device const* device = state->device;
+  pulse_slicer_timing_t scratch;
+  pulse_slicer_timing_t const* t = slicer_timing(pulses, state, &scratch);
+  int const s_short = t->s_short;
+  int const s_reset = t->s_reset;
+  int const s_tolerance = t->s_tolerance;
 
   // check for rounding to zero
-  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
-    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
+  if (t->too_low) {
+    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", state->protocol_num, device->name);
     return 0;
   }
 
+  // more than short_width*1.5 samples, exact for integer widths
+  int const s_edge = s_short * 3 / 2;
   int events = 0;
   int time_since_last = 0;
-  // bitbuffer_t bits = {0};
-  bitbuffer_clear(&bits);
+  bitbuffer_t* bits = &ctx->bits;
+  bitbuffer_clear(bits);
 
   // First rising edge is always counted as a zero (Seems to be hardcoded policy for the Oregon Scientific sensors...)
-  bitbuffer_add_bit(&bits, 0);
+  bitbuffer_add_bit(bits, 0);
 
   for (unsigned n = 0; n < pulses->num_pulses; ++n) {
+    int const pulse = pulse_data_get_pulse(pulses, n);
+    int const gap = pulse_data_get_gap(pulses, n);
     // The pulse or gap is too long or too short, thus invalid
-    if (s_tolerance > 0 && (pulses->pulse[n] < s_short - s_tolerance || pulses->pulse[n] > s_short * 2 + s_tolerance || pulses->gap[n] < s_short - s_tolerance || pulses->gap[n] > s_short * 2 + s_tolerance)) {
-      if (pulses->pulse[n] > s_short * 1.5 && pulses->pulse[n] <= s_short * 2 + s_tolerance) {
+    if (s_tolerance > 0 && (pulse < s_short - s_tolerance || pulse > s_short * 2 + s_tolerance || gap < s_short - s_tolerance || gap > s_short * 2 + s_tolerance)) {
+      if (pulse > s_edge && pulse <= s_short * 2 + s_tolerance) {
         // Long last pulse means with the gap this is a [1]10 transition, add a one
-        bitbuffer_add_bit(&bits, 1);
+        bitbuffer_add_bit(bits, 1);
       }
-      bitbuffer_add_row(&bits);
-      bitbuffer_add_bit(&bits, 0); // Prepare for new message with hardcoded 0
+      bitbuffer_add_row(bits);
+      bitbuffer_add_bit(bits, 0); // Prepare for new message with hardcoded 0
       time_since_last = 0;
     }
     // Falling edge is on end of pulse
-    else if (pulses->pulse[n] + time_since_last > (s_short * 1.5)) {
+    else if (pulse + time_since_last > s_edge) {
       // Last bit was recorded more than short_width*1.5 samples ago
       // so this pulse start must be a data edge (falling data edge means bit = 1)
-      bitbuffer_add_bit(&bits, 1);
+      bitbuffer_add_bit(bits, 1);
       time_since_last = 0;
     } else {
-      time_since_last += pulses->pulse[n];
+      time_since_last += pulse;
     }
 
     // End of Message?
     if (((n == pulses->num_pulses - 1) // No more pulses? (FSK)
-         || (pulses->gap[n] > s_reset)) // Long silence (OOK)
-        && (bits.num_rows > 0)) { // Only if data has been accumulated
-      events += account_event(device, &bits, __func__);
-      bitbuffer_clear(&bits);
-      bitbuffer_add_bit(&bits, 0); // Prepare for new message with hardcoded 0
+         || (gap > s_reset)) // Long silence (OOK)
+        && (bits->num_rows > 0)) { // Only if data has been accumulated
+      events += account_event(ctx, state, __func__);
+      bitbuffer_clear(bits);
+      bitbuffer_add_bit(bits, 0); // Prepare for new message with hardcoded 0
       time_since_last = 0;
     }
     // Rising edge is on end of gap
-    else if (pulses->gap[n] + time_since_last > (s_short * 1.5)) {
+    else if (gap + time_since_last > s_edge) {
       // Last bit was recorded more than short_width*1.5 samples ago
       // so this pulse end is a data edge (rising data edge means bit = 0)
-      bitbuffer_add_bit(&bits, 0);
+      bitbuffer_add_bit(bits, 0);
       time_since_last = 0;
     } else {
-      time_since_last += pulses->gap[n];
+      time_since_last += gap;
     }
   }
   return events;
@@ -478,29 +651,28 @@ int pulse_slicer_manchester_zerobit(pulse_data_t const* pulses, r_device* device
 
 static inline int pulse_slicer_get_symbol(pulse_data_t const* pulses, unsigned int n) {
   if (n % 2 == 0)
-    return pulses->pulse[n / 2];
+    return pulse_data_get_pulse(pulses, n / 2);
   else
-    return pulses->gap[n / 2];
+    return pulse_data_get_gap(pulses, n / 2);
 }
 
-int pulse_slicer_dmc(pulse_data_t const* pulses, r_device* device) {
-  float samples_per_us = pulses->sample_rate / 1.0e6;
-
-  int s_short = device->short_width * samples_per_us;
-  int s_long = device->long_width * samples_per_us;
-  int s_reset = device->reset_limit * samples_per_us;
-  int s_gap = device->gap_limit * samples_per_us;
-  int s_sync = device->sync_width * samples_per_us;
-  int s_tolerance = device->tolerance * samples_per_us;
+int pulse_slicer_dmc(pulse_slicer_ctx_t* ctx, pulse_data_t const* pulses, r_device_state* state) {
+  r_device const* device = state->device;
+  pulse_slicer_timing_t scratch;
+  pulse_slicer_timing_t const* t = slicer_timing(pulses, state, &scratch);
+  int const s_short = t->s_short;
+  int const s_long = t->s_long;
+  int const s_reset = t->s_reset;
+  int const s_tolerance = t->s_tolerance;
 
   // check for rounding to zero
-  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
-    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
+  if (t->too_low) {
+    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", state->protocol_num, device->name);
     return 0;
   }
 
-  // bitbuffer_t bits = {0};
-  bitbuffer_clear(&bits);
+  bitbuffer_t* bits = &ctx->bits;
+  bitbuffer_clear(bits);
   int events = 0;
 
   for (unsigned int n = 0; n < pulses->num_pulses * 2; ++n) {
@@ -508,14 +680,14 @@ int pulse_slicer_dmc(pulse_data_t const* pulses, r_device* device) {
 
     if (abs(symbol - s_short) < s_tolerance) {
       // Short - 1
-      bitbuffer_add_bit(&bits, 1);
+      bitbuffer_add_bit(bits, 1);
       symbol = pulse_slicer_get_symbol(pulses, ++n);
       if (abs(symbol - s_short) > s_tolerance) {
         if (symbol >= s_reset - s_tolerance) {
           // Don't expect another short gap at end of message
           n--;
-        } else if (bits.num_rows > 0 && bits.bits_per_row[bits.num_rows - 1] > 0) {
-          bitbuffer_add_row(&bits);
+        } else if (bits->num_rows > 0 && bits->bits_per_row[bits->num_rows - 1] > 0) {
+          bitbuffer_add_row(bits);
           /*
                     print_logf(LOG_WARNING, __func__, "Detected error during pulse_slicer_dmc(): %s",
                             device->name);
@@ -524,52 +696,51 @@ int pulse_slicer_dmc(pulse_data_t const* pulses, r_device* device) {
       }
     } else if (abs(symbol - s_long) < s_tolerance) {
       // Long - 0
-      bitbuffer_add_bit(&bits, 0);
-    } else if (symbol >= s_reset - s_tolerance && bits.num_rows > 0) { // Only if data has been accumulated
+      bitbuffer_add_bit(bits, 0);
+    } else if (symbol >= s_reset - s_tolerance && bits->num_rows > 0) { // Only if data has been accumulated
       //END message ?
-      events += account_event(device, &bits, __func__);
+      events += account_event(ctx, state, __func__);
     }
   }
 
   return events;
 }
 
-int pulse_slicer_piwm_raw(pulse_data_t const* pulses, r_device* device) {
-  float samples_per_us = pulses->sample_rate / 1.0e6;
-
-  int s_short = device->short_width * samples_per_us;
-  int s_long = device->long_width * samples_per_us;
-  int s_reset = device->reset_limit * samples_per_us;
-  int s_gap = device->gap_limit * samples_per_us;
-  int s_sync = device->sync_width * samples_per_us;
-  int s_tolerance = device->tolerance * samples_per_us;
+int pulse_slicer_piwm_raw(pulse_slicer_ctx_t* ctx, pulse_data_t const* pulses, r_device_state* state) {
+  r_device const* device = state->device;
+  pulse_slicer_timing_t scratch;
+  pulse_slicer_timing_t const* t = slicer_timing(pulses, state, &scratch);
+  int const s_short = t->s_short;
+  int const s_long = t->s_long;
+  int const s_reset = t->s_reset;
+  int const s_tolerance = t->s_tolerance;
 
   // check for rounding to zero
-  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
-    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
+  if (t->too_low) {
+    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", state->protocol_num, device->name);
     return 0;
   }
 
   // precision reciprocal
-  float f_short = device->short_width > 0.0 ? 1.0 / (device->short_width * samples_per_us) : 0;
+  int64_t const r_short = t->r_short;
 
   int w;
 
-  // bitbuffer_t bits = {0};
-  bitbuffer_clear(&bits);
+  bitbuffer_t* bits = &ctx->bits;
+  bitbuffer_clear(bits);
   int events = 0;
 
   for (unsigned int n = 0; n < pulses->num_pulses * 2; ++n) {
     int symbol = pulse_slicer_get_symbol(pulses, n);
-    w = symbol * f_short + 0.5;
+    w = slicer_bits(symbol, r_short);
     if (symbol > s_long) {
-      bitbuffer_add_row(&bits);
+      bitbuffer_add_row(bits);
     } else if (abs(symbol - w * s_short) < s_tolerance) {
       // Add w symbols
       for (; w > 0; --w)
-        bitbuffer_add_bit(&bits, 1 - n % 2);
-    } else if (symbol < s_reset && bits.num_rows > 0 && bits.bits_per_row[bits.num_rows - 1] > 0) {
-      bitbuffer_add_row(&bits);
+        bitbuffer_add_bit(bits, 1 - n % 2);
+    } else if (symbol < s_reset && bits->num_rows > 0 && bits->bits_per_row[bits->num_rows - 1] > 0) {
+      bitbuffer_add_row(bits);
       /*
             print_logf(LOG_WARNING, __func__, "Detected error during pulse_slicer_piwm_raw(): %s",
                     device->name);
@@ -578,45 +749,44 @@ int pulse_slicer_piwm_raw(pulse_data_t const* pulses, r_device* device) {
 
     if (((n == pulses->num_pulses * 2 - 1) // No more pulses? (FSK)
          || (symbol > s_reset)) // Long silence (OOK)
-        && (bits.num_rows > 0)) { // Only if data has been accumulated
+        && (bits->num_rows > 0)) { // Only if data has been accumulated
       //END message ?
-      events += account_event(device, &bits, __func__);
+      events += account_event(ctx, state, __func__);
     }
   }
 
   return events;
 }
 
-int pulse_slicer_piwm_dc(pulse_data_t const* pulses, r_device* device) {
-  float samples_per_us = pulses->sample_rate / 1.0e6;
-
-  int s_short = device->short_width * samples_per_us;
-  int s_long = device->long_width * samples_per_us;
-  int s_reset = device->reset_limit * samples_per_us;
-  int s_gap = device->gap_limit * samples_per_us;
-  int s_sync = device->sync_width * samples_per_us;
-  int s_tolerance = device->tolerance * samples_per_us;
+int pulse_slicer_piwm_dc(pulse_slicer_ctx_t* ctx, pulse_data_t const* pulses, r_device_state* state) {
+  r_device const* device = state->device;
+  pulse_slicer_timing_t scratch;
+  pulse_slicer_timing_t const* t = slicer_timing(pulses, state, &scratch);
+  int const s_short = t->s_short;
+  int const s_long = t->s_long;
+  int const s_reset = t->s_reset;
+  int const s_tolerance = t->s_tolerance;
 
   // check for rounding to zero
-  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
-    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
+  if (t->too_low) {
+    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", state->protocol_num, device->name);
     return 0;
   }
 
-  // bitbuffer_t bits = {0};
-  bitbuffer_clear(&bits);
+  bitbuffer_t* bits = &ctx->bits;
+  bitbuffer_clear(bits);
   int events = 0;
 
   for (unsigned int n = 0; n < pulses->num_pulses * 2; ++n) {
     int symbol = pulse_slicer_get_symbol(pulses, n);
     if (abs(symbol - s_short) < s_tolerance) {
       // Short - 1
-      bitbuffer_add_bit(&bits, 1);
+      bitbuffer_add_bit(bits, 1);
     } else if (abs(symbol - s_long) < s_tolerance) {
       // Long - 0
-      bitbuffer_add_bit(&bits, 0);
-    } else if (symbol < s_reset && bits.num_rows > 0 && bits.bits_per_row[bits.num_rows - 1] > 0) {
-      bitbuffer_add_row(&bits);
+      bitbuffer_add_bit(bits, 0);
+    } else if (symbol < s_reset && bits->num_rows > 0 && bits->bits_per_row[bits->num_rows - 1] > 0) {
+      bitbuffer_add_row(bits);
       /*
             print_logf(LOG_WARNING, __func__, "Detected error during pulse_slicer_piwm_dc(): %s",
                     device->name);
@@ -625,48 +795,46 @@ int pulse_slicer_piwm_dc(pulse_data_t const* pulses, r_device* device) {
 
     if (((n == pulses->num_pulses * 2 - 1) // No more pulses? (FSK)
          || (symbol > s_reset)) // Long silence (OOK)
-        && (bits.num_rows > 0)) { // Only if data has been accumulated
+        && (bits->num_rows > 0)) { // Only if data has been accumulated
       //END message ?
-      events += account_event(device, &bits, __func__);
+      events += account_event(ctx, state, __func__);
     }
   }
 
   return events;
 }
 
-int pulse_slicer_nrzs(pulse_data_t const* pulses, r_device* device) {
-  float samples_per_us = pulses->sample_rate / 1.0e6;
-
-  int s_short = device->short_width * samples_per_us;
-  int s_long = device->long_width * samples_per_us;
-  int s_reset = device->reset_limit * samples_per_us;
-  int s_gap = device->gap_limit * samples_per_us;
-  int s_sync = device->sync_width * samples_per_us;
-  int s_tolerance = device->tolerance * samples_per_us;
+int pulse_slicer_nrzs(pulse_slicer_ctx_t* ctx, pulse_data_t const* pulses, r_device_state* state) {
+  r_device const* device = state->device;
+  pulse_slicer_timing_t scratch;
+  pulse_slicer_timing_t const* t = slicer_timing(pulses, state, &scratch);
+  int const s_short = t->s_short;
+  int const s_reset = t->s_reset;
 
   // check for rounding to zero
-  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
-    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
+  if (t->too_low) {
+    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", state->protocol_num, device->name);
     return 0;
   }
 
   int events = 0;
-  // bitbuffer_t bits = {0};
-  bitbuffer_clear(&bits);
+  bitbuffer_t* bits = &ctx->bits;
+  bitbuffer_clear(bits);
   int limit = s_short;
 
   for (unsigned n = 0; n < pulses->num_pulses; ++n) {
-    if (pulses->pulse[n] > limit) {
-      for (int i = 0; i < (pulses->pulse[n] / limit); i++) {
-        bitbuffer_add_bit(&bits, 1);
+    int const pulse = pulse_data_get_pulse(pulses, n);
+    if (pulse > limit) {
+      for (int i = 0; i < (pulse / limit); i++) {
+        bitbuffer_add_bit(bits, 1);
       }
-      bitbuffer_add_bit(&bits, 0);
-    } else if (pulses->pulse[n] < limit) {
-      bitbuffer_add_bit(&bits, 0);
+      bitbuffer_add_bit(bits, 0);
+    } else if (pulse < limit) {
+      bitbuffer_add_bit(bits, 0);
     }
 
-    if (n == pulses->num_pulses - 1 || pulses->gap[n] >= s_reset) {
-      events += account_event(device, &bits, __func__);
+    if (n == pulses->num_pulses - 1 || pulse_data_get_gap(pulses, n) >= s_reset) {
+      events += account_event(ctx, state, __func__);
     }
   }
 
@@ -686,19 +854,16 @@ int pulse_slicer_nrzs(pulse_data_t const* pulses, r_device* device) {
  * bit is discarded.
  */
 
-int pulse_slicer_osv1(pulse_data_t const* pulses, r_device* device) {
-  float samples_per_us = pulses->sample_rate / 1.0e6;
-
-  int s_short = device->short_width * samples_per_us;
-  int s_long = device->long_width * samples_per_us;
-  int s_reset = device->reset_limit * samples_per_us;
-  int s_gap = device->gap_limit * samples_per_us;
-  int s_sync = device->sync_width * samples_per_us;
-  int s_tolerance = device->tolerance * samples_per_us;
+int pulse_slicer_osv1(pulse_slicer_ctx_t* ctx, pulse_data_t const* pulses, r_device_state* state) {
+  r_device const* device = state->device;
+  pulse_slicer_timing_t scratch;
+  pulse_slicer_timing_t const* t = slicer_timing(pulses, state, &scratch);
+  int const s_short = t->s_short;
+  int const s_reset = t->s_reset;
 
   // check for rounding to zero
-  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
-    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
+  if (t->too_low) {
+    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", state->protocol_num, device->name);
     return 0;
   }
 
@@ -706,76 +871,76 @@ int pulse_slicer_osv1(pulse_data_t const* pulses, r_device* device) {
   int preamble = 0;
   int events = 0;
   int manbit = 0;
-  // bitbuffer_t bits = {0};
-  bitbuffer_clear(&bits);
+  bitbuffer_t* bits = &ctx->bits;
+  bitbuffer_clear(bits);
   int halfbit_min = s_short / 2;
   int halfbit_max = s_short * 3 / 2;
   int sync_min = 2 * halfbit_max;
 
   /* preamble */
   for (n = 0; n < pulses->num_pulses; ++n) {
-    if (pulses->pulse[n] > halfbit_min && pulses->gap[n] > halfbit_min) {
+    if (pulse_data_get_pulse(pulses, n) > halfbit_min && pulse_data_get_gap(pulses, n) > halfbit_min) {
       preamble++;
-      if (pulses->gap[n] > halfbit_max)
+      if (pulse_data_get_gap(pulses, n) > halfbit_max)
         break;
     } else
       return events;
   }
   if (preamble != 12) {
-    if (device->verbose)
-      print_logf(LOG_WARNING, __func__, "preamble %d  %d %d", preamble, pulses->pulse[0], pulses->gap[0]);
+    if (state->verbose)
+      print_logf(LOG_WARNING, __func__, "preamble %d  %d %d", preamble, pulse_data_get_pulse(pulses, 0), pulse_data_get_gap(pulses, 0));
     return events;
   }
 
   /* sync */
   ++n;
-  if (pulses->pulse[n] < sync_min || pulses->gap[n] < sync_min) {
+  if (pulse_data_get_pulse(pulses, n) < sync_min || pulse_data_get_gap(pulses, n) < sync_min) {
     return events;
   }
 
   /* data bits - manchester encoding */
 
   /* sync gap could be part of data when the first bit is 0 */
-  if (pulses->gap[n] > pulses->pulse[n]) {
+  if (pulse_data_get_gap(pulses, n) > pulse_data_get_pulse(pulses, n)) {
     manbit ^= 1;
     if (manbit)
-      bitbuffer_add_bit(&bits, 0);
+      bitbuffer_add_bit(bits, 0);
   }
 
   /* remaining data bits */
   for (n++; n < pulses->num_pulses; ++n) {
     manbit ^= 1;
     if (manbit)
-      bitbuffer_add_bit(&bits, 1);
-    if (pulses->pulse[n] > halfbit_max) {
+      bitbuffer_add_bit(bits, 1);
+    if (pulse_data_get_pulse(pulses, n) > halfbit_max) {
       manbit ^= 1;
       if (manbit)
-        bitbuffer_add_bit(&bits, 1);
+        bitbuffer_add_bit(bits, 1);
     }
-    if ((n == pulses->num_pulses - 1 || pulses->gap[n] > s_reset) && (bits.num_rows > 0)) { // Only if data has been accumulated
+    if ((n == pulses->num_pulses - 1 || pulse_data_get_gap(pulses, n) > s_reset) && (bits->num_rows > 0)) { // Only if data has been accumulated
       //END message ?
-      events += account_event(device, &bits, __func__);
+      events += account_event(ctx, state, __func__);
       return events;
     }
     manbit ^= 1;
     if (manbit)
-      bitbuffer_add_bit(&bits, 0);
-    if (pulses->gap[n] > halfbit_max) {
+      bitbuffer_add_bit(bits, 0);
+    if (pulse_data_get_gap(pulses, n) > halfbit_max) {
       manbit ^= 1;
       if (manbit)
-        bitbuffer_add_bit(&bits, 0);
+        bitbuffer_add_bit(bits, 0);
     }
   }
   return events;
 }
 
-int pulse_slicer_string(const char* code, r_device* device) {
+int pulse_slicer_string(const char* code, r_device_state* state) {
   int events = 0;
   bitbuffer_t bits = {0};
 
   bitbuffer_parse(&bits, code);
 
-  events += account_event(device, &bits, __func__);
+  events += account_decode(state, &bits, __func__);
 
   return events;
 }
@@ -19,6 +19,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "bitbuffer.h"
+#include "pulse_analyzer.h"
 #include "pulse_slicer.h"
 #include "r_device.h"
 #include "r_private.h"
@@ -28,6 +30,7 @@
 // #include "pulse_detect_fsk.h"
 // #include "compat_time.h"
 #include "data.h"
+#include "decoder_util.h"
 // #include "data_tag.h"
 #include "fatal.h"
 // #include "http_server.h"
@@ -57,6 +60,17 @@
 #  include <unistd.h>
 #endif
 
+#ifdef PARALLEL_DEMOD
+#  ifdef ESP32
+#    include "freertos/FreeRTOS.h"
+#    include "freertos/semphr.h"
+#    include "freertos/task.h"
+#  else
+#    include <pthread.h>
+#    include <semaphore.h>
+#  endif
+#endif
+
 #ifndef _MSC_VER
 #  include <getopt.h>
 #else
@@ -248,7 +262,175 @@ void r_free_cfg(r_cfg_t *cfg) {
 
 /* device decoder protocols */
 
-void register_protocol(r_cfg_t* cfg, r_device* r_dev, char* arg) {
+/// Slicer for a modulation, NULL if unknown.
+static demod_slicer_fn slicer_for(unsigned modulation) {
+  switch (modulation) {
+    case OOK_PULSE_PCM:
+      // case OOK_PULSE_RZ:
+    case FSK_PULSE_PCM:
+      return pulse_slicer_pcm;
+    case OOK_PULSE_PPM:
+      return pulse_slicer_ppm;
+    case OOK_PULSE_PWM:
+    case FSK_PULSE_PWM:
+      return pulse_slicer_pwm;
+    case OOK_PULSE_MANCHESTER_ZEROBIT:
+    case FSK_PULSE_MANCHESTER_ZEROBIT:
+      return pulse_slicer_manchester_zerobit;
+    case OOK_PULSE_PIWM_RAW:
+      return pulse_slicer_piwm_raw;
+    case OOK_PULSE_PIWM_DC:
+      return pulse_slicer_piwm_dc;
+    case OOK_PULSE_DMC:
+      return pulse_slicer_dmc;
+    case OOK_PULSE_PWM_OSV1:
+      return pulse_slicer_osv1;
+    case OOK_PULSE_NRZS:
+      return pulse_slicer_nrzs;
+    default:
+      return NULL;
+  }
+}
+
+/// Slicers that start over after each event, so that decoders with identical
+/// timings can share their output.
+static int slicer_can_share(demod_slicer_fn slicer) {
+  return slicer == pulse_slicer_pcm || slicer == pulse_slicer_ppm ||
+         slicer == pulse_slicer_pwm ||
+         slicer == pulse_slicer_manchester_zerobit ||
+         slicer == pulse_slicer_osv1;
+}
+
+/// Width check that rules out a decoder before slicing, only for slicers with
+/// precise bounds.
+static unsigned prefilter_for(demod_slicer_fn slicer, r_device const* r_dev) {
+  if (r_dev->tolerance <= 0)
+    return DEMOD_PREFILTER_NONE;
+  if (slicer == pulse_slicer_pwm)
+    return DEMOD_PREFILTER_PULSE;
+  if (slicer == pulse_slicer_ppm)
+    return DEMOD_PREFILTER_GAP;
+  if (slicer == pulse_slicer_manchester_zerobit)
+    return DEMOD_PREFILTER_MANCHESTER;
+  return DEMOD_PREFILTER_NONE;
+}
+
+/// Coding family a slicer reads data from, see pulse_timing_analyze().
+/// Decoders with short and long widths too close to be told apart by the
+/// analysis are never ruled out by the coding.
+static unsigned coding_for(demod_slicer_fn slicer, r_device const* r_dev) {
+  if (!pulse_timing_separable(r_dev->short_width, r_dev->long_width))
+    return PULSE_CODING_OTHER;
+  if (slicer == pulse_slicer_pwm)
+    return PULSE_CODING_PWM;
+  if (slicer == pulse_slicer_ppm)
+    return PULSE_CODING_PPM;
+  return PULSE_CODING_OTHER;
+}
+
+static int same_timing(r_device const* a, r_device const* b) {
+  return a->modulation == b->modulation && a->short_width == b->short_width &&
+         a->long_width == b->long_width && a->reset_limit == b->reset_limit &&
+         a->gap_limit == b->gap_limit && a->sync_width == b->sync_width &&
+         a->tolerance == b->tolerance;
+}
+
+/// Add a decoder to the group of an entry with the same slicer and timings.
+static int join_demod_group(demod_list_t* list, demod_slicer_fn slicer,
+                            r_device_state* state) {
+  if (!slicer_can_share(slicer))
+    return 0;
+  for (unsigned i = 0; i < list->len; ++i) {
+    demod_entry_t* entry = &list->entries[i];
+    if (entry->priority != state->device->priority ||
+        !same_timing(entry->state->device, state->device))
+      continue;
+
+    r_device_state** group =
+        realloc(entry->group, (entry->group_len + 1) * sizeof(*group));
+    if (!group)
+      FATAL_REALLOC("join_demod_group()");
+    if (!entry->group)
+      group[0] = entry->state;
+    group[entry->group_len++] = state;
+    entry->group = group;
+    return 1;
+  }
+  return 0;
+}
+
+/// Insert a registered decoder into the OOK or FSK dispatch list, ordered by
+/// priority, then by modulation, then by registration. Decoders with the same
+/// slicer and timings as an earlier one share its entry.
+static void add_demod(struct dm_state* demod, r_device_state* state) {
+  r_device const* r_dev = state->device;
+  demod_slicer_fn slicer = slicer_for(r_dev->modulation);
+  if (!slicer) {
+    fprintf(stderr, "Unknown modulation %u in protocol!\n", r_dev->modulation);
+    return;
+  }
+  demod_list_t* list = r_dev->modulation < FSK_DEMOD_MIN_VAL
+                           ? &demod->ook_demods
+                           : &demod->fsk_demods;
+  if (join_demod_group(list, slicer, state))
+    return;
+
+  demod_entry_t* entries =
+      realloc(list->entries, (list->len + 1) * sizeof(*entries));
+  if (!entries)
+    FATAL_REALLOC("add_demod()");
+  list->entries = entries;
+
+  unsigned pos = list->len;
+  while (pos > 0 &&
+         (entries[pos - 1].priority > r_dev->priority ||
+          (entries[pos - 1].priority == r_dev->priority &&
+           entries[pos - 1].state->device->modulation > r_dev->modulation)))
+    pos--;
+  memmove(&entries[pos + 1], &entries[pos],
+          (list->len - pos) * sizeof(*entries));
+  entries[pos].slicer = slicer;
+  entries[pos].state = state;
+  entries[pos].priority = r_dev->priority;
+  entries[pos].group = NULL;
+  entries[pos].group_len = 1;
+  entries[pos].prefilter = prefilter_for(slicer, r_dev);
+  entries[pos].coding = coding_for(slicer, r_dev);
+  list->len++;
+}
+
+/// Empty a dispatch list, keeps the entries for reuse.
+static void clear_demods(demod_list_t* list) {
+  for (unsigned i = 0; i < list->len; ++i)
+    free(list->entries[i].group);
+  list->len = 0;
+}
+
+/// Dispatch the registered decoders again after some were added or removed
+/// at runtime, in the order of r_devs. Never called while a train is decoded.
+static void rebuild_demods(struct dm_state* demod) {
+  clear_demods(&demod->ook_demods);
+  clear_demods(&demod->fsk_demods);
+  for (void** iter = demod->r_devs.elems; iter && *iter; ++iter)
+    add_demod(demod, *iter);
+}
+
+/// A registered decoder, its state and timings in one allocation.
+typedef struct registered_device {
+  r_device_state state;
+  pulse_slicer_timing_t timing;
+} registered_device_t;
+
+/// Index of a decoder in the device list, the next free number if not listed.
+static unsigned protocol_num_for(r_cfg_t* cfg, r_device const* r_dev) {
+  for (unsigned i = 0; i < cfg->num_r_devices; ++i) {
+    if (cfg->devices[i] == r_dev)
+      return i;
+  }
+  return cfg->num_r_devices;
+}
+
+void register_protocol(r_cfg_t* cfg, r_device const* r_dev, char* arg) {
   // use arg of 'v', 'vv', 'vvv' as device verbosity
   int dev_verbose = 0;
   if (arg && *arg == 'v') {
@@ -260,54 +442,84 @@ void register_protocol(r_cfg_t* cfg, r_device* r_dev, char* arg) {
     }
   }
 
-  // use any other arg as device parameter
-  r_device* p;
+  registered_device_t* reg = calloc(1, sizeof(*reg));
+  if (!reg)
+    FATAL_CALLOC("register_protocol()");
+  r_device_state* state = &reg->state;
+
+  // use any other arg as device parameter, otherwise just link the decoder
   if (r_dev->create_fn) {
-    p = r_dev->create_fn(arg);
+    state->created = r_dev->create_fn(arg);
+    state->device = state->created;
   } else {
     if (arg && *arg) {
       fprintf(stderr, "Protocol [%u] \"%s\" does not take arguments \"%s\"!\n",
-              r_dev->protocol_num, r_dev->name, arg);
+              protocol_num_for(cfg, r_dev), r_dev->name, arg);
     }
-    p = malloc(sizeof(*p));
-    if (!p)
-      FATAL_CALLOC("register_protocol()");
-    *p = *r_dev; // copy
+    state->device = r_dev;
   }
+  state->protocol_num = protocol_num_for(cfg, r_dev);
+
+  state->verbose = dev_verbose ? dev_verbose : (cfg->verbosity > 4 ? cfg->verbosity - 5 : 0);
 
-  p->verbose = dev_verbose ? dev_verbose : (cfg->verbosity > 4 ? cfg->verbosity - 5 : 0);
+  state->log_fn = log_device_handler;
 
-  p->log_fn = log_device_handler;
+  state->output_fn = data_acquired_handler;
+  state->output_ctx = cfg;
+  state->decode_ctx = state->device->decode_ctx;
 
-  p->output_fn = data_acquired_handler;
-  p->output_ctx = cfg;
+  state->slicer_timing = &reg->timing;
+  pulse_slicer_timing_init(state->slicer_timing, state->device, PULSE_SLICER_SAMPLE_RATE);
 
-  list_push(&cfg->demod->r_devs, p);
+  // keep the decoders in protocol number order, as registered at startup
+  list_t* r_devs = &cfg->demod->r_devs;
+  list_push(r_devs, state);
+  size_t pos = r_devs->len - 1;
+  for (; pos > 0 &&
+         ((r_device_state*)r_devs->elems[pos - 1])->protocol_num > state->protocol_num;
+       --pos) {
+    r_devs->elems[pos] = r_devs->elems[pos - 1];
+    r_devs->elems[pos - 1] = state;
+  }
+  if (pos == r_devs->len - 1)
+    add_demod(cfg->demod, state);
+  else
+    rebuild_demods(cfg->demod); // enabled at runtime, dispatch as if at startup
+  decoder_link_state(state);
 
   if (cfg->verbosity >= LOG_INFO) {
-    fprintf(stderr, "Registering protocol [%u] \"%s\"\n", r_dev->protocol_num,
+    fprintf(stderr, "Registering protocol [%u] \"%s\"\n", state->protocol_num,
             r_dev->name);
   }
 }
 
-/*
-void free_protocol(r_device *r_dev) {
-  // free(r_dev->name);
-  free(r_dev->decode_ctx);
-  free(r_dev);
+void free_protocol(r_device_state* state) {
+  decoder_unlink_state(state);
+  if (state->created) {
+    free(state->created->decode_ctx);
+    free(state->created);
+  }
+  free(state); // the state starts its registered_device_t
 }
 
-void unregister_protocol(r_cfg_t *cfg, r_device *r_dev) {
-  for (size_t i = 0; i < cfg->demod->r_devs.len;
-       ++i) { // list might contain NULLs
-    r_device *p = cfg->demod->r_devs.elems[i];
-    if (!strcmp(p->name, r_dev->name)) {
+void unregister_protocol(r_cfg_t* cfg, r_device const* r_dev) {
+  unsigned protocol_num = protocol_num_for(cfg, r_dev);
+  int removed = 0;
+  for (size_t i = 0; i < cfg->demod->r_devs.len; ++i) {
+    r_device_state* state = cfg->demod->r_devs.elems[i];
+    // a created decoder is found by its number in the device list
+    if (state->device == r_dev || (protocol_num < cfg->num_r_devices &&
+                                   state->protocol_num == protocol_num)) {
       list_remove(&cfg->demod->r_devs, i, (list_elem_free_fn)free_protocol);
       i--; // so we don't skip the next elem now shifted down
+      removed = 1;
     }
   }
+  if (removed)
+    rebuild_demods(cfg->demod);
 }
 
+/*
 void register_all_protocols(r_cfg_t *cfg, unsigned disabled) {
   for (int i = 0; i < cfg->num_r_devices; i++) {
     // register all device protocols that are not disabled
@@ -510,150 +722,257 @@ char const **determine_csv_fields(r_cfg_t *cfg, char const *const *well_known,
 
 */
 
-int run_ook_demods(list_t* r_devs, pulse_data_t* pulse_data) {
-  int p_events = 0;
-
-  unsigned next_priority = 0; // next smallest on each loop through decoders
-  // run all decoders of each priority, stop if an event is produced
-  for (unsigned priority = 0; !p_events && priority < UINT_MAX;
-       priority = next_priority) {
-    next_priority = UINT_MAX;
-    for (void** iter = r_devs->elems; iter && *iter; ++iter) {
-      r_device* r_dev = *iter;
-
-      // Find next smallest priority
-      if (r_dev->priority > priority && r_dev->priority < next_priority)
-        next_priority = r_dev->priority;
-      // Run only current priority
-      if (r_dev->priority != priority)
-        continue;
+static inline int run_demod(pulse_slicer_ctx_t* ctx,
+                            demod_entry_t const* entry,
+                            pulse_data_t* pulse_data) {
+  r_device_state* state = entry->state;
 #ifdef RTL_DEBUG
-        // logprintfLn(LOG_DEBUG, "demod(%d) - %s", r_dev->modulation, r_dev->name);
+  // logprintfLn(LOG_DEBUG, "demod(%d) - %s", r_dev->modulation, r_dev->name);
 #endif
 #ifdef RESOURCE_DEBUG
-      int preStack = uxTaskGetStackHighWaterMark(NULL);
+  int preStack = uxTaskGetStackHighWaterMark(NULL);
 #endif
-
-      switch (r_dev->modulation) {
-        case OOK_PULSE_PCM:
-          // case OOK_PULSE_RZ:
-          p_events += pulse_slicer_pcm(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PPM:
-          p_events += pulse_slicer_ppm(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PWM:
-          p_events += pulse_slicer_pwm(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_MANCHESTER_ZEROBIT:
-          p_events += pulse_slicer_manchester_zerobit(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PIWM_RAW:
-          p_events += pulse_slicer_piwm_raw(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PIWM_DC:
-          p_events += pulse_slicer_piwm_dc(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_DMC:
-          p_events += pulse_slicer_dmc(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PWM_OSV1:
-          p_events += pulse_slicer_osv1(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_NRZS:
-          p_events += pulse_slicer_nrzs(pulse_data, r_dev);
-          break;
-        // FSK decoders
-        case FSK_PULSE_PCM:
-        case FSK_PULSE_PWM:
-        case FSK_PULSE_MANCHESTER_ZEROBIT:
-          break;
-        default:
-          fprintf(stderr, "Unknown modulation %u in protocol!\n",
-                  r_dev->modulation);
-      }
+  ctx->group = entry->group;
+  ctx->group_len = entry->group_len;
+  int p_events = entry->slicer(ctx, pulse_data, state);
+  ctx->group = NULL;
 #ifdef RESOURCE_DEBUG
-      int delta = preStack - uxTaskGetStackHighWaterMark(NULL);
-      if (delta) {
-        logprintfLn(LOG_DEBUG, "Process rtl_433_DecoderTask resource hit demod(%d) - %s, delta %d, stack free: %u", r_dev->modulation, r_dev->name,
-                    delta, uxTaskGetStackHighWaterMark(NULL));
-      }
+  r_device const* r_dev = state->device;
+  int delta = preStack - uxTaskGetStackHighWaterMark(NULL);
+  if (delta) {
+    logprintfLn(LOG_DEBUG, "Process rtl_433_DecoderTask resource hit demod(%d) - %s, delta %d, stack free: %u", r_dev->modulation, r_dev->name,
+                delta, uxTaskGetStackHighWaterMark(NULL));
+  }
 #endif
 #ifdef RTL_ANALYZE
-      // logprintfLn(LOG_DEBUG, "RTL_ANALYZE_MODEL %s==%d", r_dev->name, r_dev->protocol_num);
-      if (r_dev->protocol_num == RTL_ANALYZE) {
-        pulse_analyzer(pulse_data, 1);
-      }
-#endif
+  // logprintfLn(LOG_DEBUG, "RTL_ANALYZE_MODEL %s==%d", r_dev->name, r_dev->protocol_num);
+  for (unsigned i = 0; i < entry->group_len; ++i) {
+    r_device_state* member = entry->group ? entry->group[i] : state;
+    if (member->device->modulation < FSK_DEMOD_MIN_VAL &&
+        member->protocol_num == RTL_ANALYZE) {
+      pulse_analyzer(pulse_data, 1);
     }
   }
-
+#endif
   return p_events;
 }
 
-int run_fsk_demods(list_t* r_devs, pulse_data_t* fsk_pulse_data) {
+/// Check if the slicer of a decoder can find any bit in a train with this
+/// timing, using the same bounds as the slicer.
+static int demod_plausible(demod_entry_t const* entry,
+                           pulse_timing_t const* timing,
+                           pulse_data_t const* pulse_data) {
+  if (!(entry->coding & timing->codings))
+    return 0;
+  if (entry->prefilter == DEMOD_PREFILTER_NONE)
+    return 1;
+
+  // timings for another sample rate are left to the slicer
+  pulse_slicer_timing_t const* t = entry->state->slicer_timing;
+  if (t->sample_rate != pulse_data->sample_rate || t->s_tolerance <= 0)
+    return 1;
+  int const s_short = t->s_short;
+  int const s_long = t->s_long;
+  int const s_tolerance = t->s_tolerance;
+
+  switch (entry->prefilter) {
+    case DEMOD_PREFILTER_PULSE:
+      return pulse_timing_has_pulse(timing, s_short - s_tolerance,
+                                    s_short + s_tolerance) ||
+             pulse_timing_has_pulse(timing, s_long - s_tolerance,
+                                    s_long + s_tolerance);
+    case DEMOD_PREFILTER_GAP:
+      return pulse_timing_has_gap(timing, s_short - s_tolerance,
+                                  s_short + s_tolerance) ||
+             pulse_timing_has_gap(timing, s_long - s_tolerance,
+                                  s_long + s_tolerance);
+    case DEMOD_PREFILTER_MANCHESTER:
+      return pulse_timing_has_pulse(timing, s_short - s_tolerance - 1,
+                                    s_short * 2 + s_tolerance + 1);
+    default:
+      return 1;
+  }
+}
+
+/// Run every stride-th decoder of a priority level, starting with the first,
+/// skipping decoders the timing of the train rules out.
+static int run_priority_demods(pulse_slicer_ctx_t* ctx,
+                               demod_entry_t const* level, unsigned len,
+                               pulse_data_t* pulse_data,
+                               pulse_timing_t const* timing, unsigned first,
+                               unsigned stride) {
   int p_events = 0;
+  for (unsigned i = first; i < len; i += stride) {
+    if (demod_plausible(&level[i], timing, pulse_data))
+      p_events += run_demod(ctx, &level[i], pulse_data);
+  }
+  return p_events;
+}
 
-  unsigned next_priority = 0; // next smallest on each loop through decoders
-  // run all decoders of each priority, stop if an event is produced
-  for (unsigned priority = 0; !p_events && priority < UINT_MAX;
-       priority = next_priority) {
-    next_priority = UINT_MAX;
-    for (void** iter = r_devs->elems; iter && *iter; ++iter) {
-      r_device* r_dev = *iter;
-
-      // Find next smallest priority
-      if (r_dev->priority > priority && r_dev->priority < next_priority)
-        next_priority = r_dev->priority;
-      // Run only current priority
-      if (r_dev->priority != priority)
-        continue;
+#ifdef PARALLEL_DEMOD
+
+/* parallel demodulation
+
+   The decoders of each priority level are split between the decoder task and
+   a worker task on the other core ( a thread on the host ). Both only read the
+   pulse train, each slices with its own slicer context and output is serialized
+   in the handlers below. The next priority level runs only after both are
+   done and neither produced an event. */
+
+#  ifdef ESP32
+#    ifndef PARALLEL_DEMOD_STACK
+#      define PARALLEL_DEMOD_STACK 20000
+#    endif
+#    define PARALLEL_DEMOD_CORE     0
+#    define PARALLEL_DEMOD_PRIORITY 2
+
+typedef SemaphoreHandle_t demod_sem_t;
+#    define demod_sem_init(s)  ((*(s) = xSemaphoreCreateBinary()) != NULL)
+#    define demod_sem_give(s)  xSemaphoreGive(*(s))
+#    define demod_sem_take(s)  xSemaphoreTake(*(s), portMAX_DELAY)
+#    define demod_lock_init(s) ((*(s) = xSemaphoreCreateMutex()) != NULL)
+#    define demod_lock(s)      xSemaphoreTake(*(s), portMAX_DELAY)
+#    define demod_unlock(s)    xSemaphoreGive(*(s))
+#  else
+typedef sem_t demod_sem_t;
+#    define demod_sem_init(s)  (sem_init(s, 0, 0) == 0)
+#    define demod_sem_give(s)  sem_post(s)
+#    define demod_sem_take(s)  sem_wait(s)
+#    define demod_lock_init(s) (sem_init(s, 0, 1) == 0)
+#    define demod_lock(s)      sem_wait(s)
+#    define demod_unlock(s)    sem_post(s)
+#  endif
 
-#ifdef RTL_DEBUG
-        // logprintfLn(LOG_DEBUG, "demod(%d) - %s", r_dev->modulation, r_dev->name);
-#endif
-#ifdef RESOURCE_DEBUG
-      int preStack = uxTaskGetStackHighWaterMark(NULL);
+/// Work handed to the worker for one priority level.
+static struct {
+  demod_entry_t const* level;
+  unsigned len;
+  pulse_data_t* pulse_data;
+  pulse_timing_t const* timing;
+  int p_events;
+} demod_job;
+
+static demod_sem_t demod_start;
+static demod_sem_t demod_done;
+static demod_sem_t demod_output;
+static int demod_worker_state; // 0: not started, 1: running, -1: failed
+
+static void demod_worker_loop(void) {
+  static pulse_slicer_ctx_t worker_ctx;
+  for (;;) {
+    demod_sem_take(&demod_start);
+    demod_job.p_events =
+        run_priority_demods(&worker_ctx, demod_job.level, demod_job.len,
+                            demod_job.pulse_data, demod_job.timing, 1, 2);
+    demod_sem_give(&demod_done);
+  }
+}
+
+#  ifdef ESP32
+static void demod_worker_task(void* parameter) {
+  (void)parameter;
+  demod_worker_loop();
+}
+#  else
+static void* demod_worker_thread(void* parameter) {
+  (void)parameter;
+  demod_worker_loop();
+  return NULL;
+}
+#  endif
+
+static int demod_worker_start(void) {
+  if (!demod_sem_init(&demod_start) || !demod_sem_init(&demod_done) ||
+      !demod_lock_init(&demod_output))
+    return -1;
+#  ifdef ESP32
+  TaskHandle_t handle;
+  if (xTaskCreatePinnedToCore(demod_worker_task, "rtl_433_Demod",
+                              PARALLEL_DEMOD_STACK, NULL,
+                              PARALLEL_DEMOD_PRIORITY, &handle,
+                              PARALLEL_DEMOD_CORE) != pdPASS)
+    return -1;
+#  else
+  pthread_t thread;
+  if (pthread_create(&thread, NULL, demod_worker_thread, NULL))
+    return -1;
+#  endif
+  return 1;
+}
+
+static int run_priority_demods_parallel(pulse_slicer_ctx_t* ctx,
+                                        demod_entry_t const* level,
+                                        unsigned len,
+                                        pulse_data_t* pulse_data,
+                                        pulse_timing_t const* timing) {
+  if (!demod_worker_state) {
+    demod_worker_state = demod_worker_start();
+    if (demod_worker_state < 0)
+      fprintf(stderr, "Parallel demodulation worker failed to start!\n");
+  }
+  if (demod_worker_state < 0 || len < 2)
+    return run_priority_demods(ctx, level, len, pulse_data, timing, 0, 1);
+
+  demod_job.level = level;
+  demod_job.len = len;
+  demod_job.pulse_data = pulse_data;
+  demod_job.timing = timing;
+  demod_sem_give(&demod_start);
+  int p_events =
+      run_priority_demods(ctx, level, len, pulse_data, timing, 0, 2);
+  demod_sem_take(&demod_done);
+  return p_events + demod_job.p_events;
+}
+
+/// Serialize output of both tasks, a no-op until the worker runs.
+static void output_lock(void) {
+  if (demod_worker_state > 0)
+    demod_lock(&demod_output);
+}
+
+static void output_unlock(void) {
+  if (demod_worker_state > 0)
+    demod_unlock(&demod_output);
+}
+#else
+static inline void output_lock(void) {}
+static inline void output_unlock(void) {}
 #endif
-      switch (r_dev->modulation) {
-        // OOK decoders
-        case OOK_PULSE_PCM:
-        // case OOK_PULSE_RZ:
-        case OOK_PULSE_PPM:
-        case OOK_PULSE_PWM:
-        case OOK_PULSE_MANCHESTER_ZEROBIT:
-        case OOK_PULSE_PIWM_RAW:
-        case OOK_PULSE_PIWM_DC:
-        case OOK_PULSE_DMC:
-        case OOK_PULSE_PWM_OSV1:
-        case OOK_PULSE_NRZS:
-          break;
-        case FSK_PULSE_PCM:
-          p_events += pulse_slicer_pcm(fsk_pulse_data, r_dev);
-          break;
-        case FSK_PULSE_PWM:
-          p_events += pulse_slicer_pwm(fsk_pulse_data, r_dev);
-          break;
-        case FSK_PULSE_MANCHESTER_ZEROBIT:
-          p_events += pulse_slicer_manchester_zerobit(fsk_pulse_data, r_dev);
-          break;
-        default:
-          fprintf(stderr, "Unknown modulation %u in protocol!\n",
-                  r_dev->modulation);
-      }
-#ifdef RESOURCE_DEBUG
-      int delta = preStack - uxTaskGetStackHighWaterMark(NULL);
-      if (delta) {
-        logprintfLn(LOG_DEBUG, "Process rtl_433_DecoderTask resource hit demod(%d) - %s, delta %d, stack free: %u", r_dev->modulation, r_dev->name,
-                    delta, uxTaskGetStackHighWaterMark(NULL));
-      }
+
+/// Run all decoders of each priority, stop if an event is produced.
+static int run_demods(pulse_slicer_ctx_t* ctx, demod_list_t const* list,
+                      pulse_data_t* pulse_data) {
+  int p_events = 0;
+
+  pulse_timing_t timing;
+  pulse_timing_analyze(&timing, pulse_data);
+
+  unsigned end;
+  for (unsigned start = 0; !p_events && start < list->len; start = end) {
+    unsigned priority = list->entries[start].priority;
+    for (end = start + 1;
+         end < list->len && list->entries[end].priority == priority; ++end)
+      ;
+#ifdef PARALLEL_DEMOD
+    p_events = run_priority_demods_parallel(ctx, &list->entries[start],
+                                            end - start, pulse_data, &timing);
+#else
+    p_events = run_priority_demods(ctx, &list->entries[start], end - start,
+                                   pulse_data, &timing, 0, 1);
 #endif
-    }
   }
 
   return p_events;
 }
 
+int run_ook_demods(struct dm_state* demod, pulse_data_t* pulse_data) {
+  return run_demods(&demod->slicer_ctx, &demod->ook_demods, pulse_data);
+}
+
+int run_fsk_demods(struct dm_state* demod, pulse_data_t* fsk_pulse_data) {
+  return run_demods(&demod->slicer_ctx, &demod->fsk_demods, fsk_pulse_data);
+}
+
 /* handlers */
 
 /*
@@ -718,8 +1037,9 @@ void event_occurred_handler(r_cfg_t *cfg, data_t *data) {
 
 /** Pass the data structure to all output handlers. Frees data afterwards. */
 
-void log_device_handler(r_device* r_dev, int level, data_t* data) {
-  r_cfg_t* cfg = r_dev->output_ctx;
+void log_device_handler(r_device_state* state, int level, data_t* data) {
+  r_cfg_t* cfg = state->output_ctx;
+  output_lock();
   // prepend "time" if requested
   /*
    if (cfg->report_time != REPORT_TIME_OFF) {
@@ -736,13 +1056,123 @@ void log_device_handler(r_device* r_dev, int level, data_t* data) {
       data_output_print(output, data);
     }
   }
+  output_unlock();
   data_free(data);
 }
 
+/* duplicate message suppression */
+
+#define DEDUP_CACHE_SIZE 8
+
+/// Recently delivered messages, hash of decoder and fields with time in ms.
+static struct {
+  uint32_t hash;
+  uint32_t time_ms;
+} dedup_cache[DEDUP_CACHE_SIZE];
+static unsigned dedup_next;
+
+static uint32_t hash_bytes(uint32_t hash, void const* buf, size_t len) {
+  uint8_t const* p = buf;
+  for (size_t i = 0; i < len; ++i) {
+    hash = (hash ^ p[i]) * 16777619u; // FNV-1a
+  }
+  return hash;
+}
+
+static uint32_t hash_data(uint32_t hash, data_t const* data);
+
+static uint32_t hash_array(uint32_t hash, data_array_t const* array) {
+  for (int i = 0; i < array->num_values; ++i) {
+    switch (array->type) {
+      case DATA_INT:
+        hash = hash_bytes(hash, (int const*)array->values + i, sizeof(int));
+        break;
+      case DATA_DOUBLE:
+        hash = hash_bytes(hash, (double const*)array->values + i,
+                          sizeof(double));
+        break;
+      case DATA_STRING: {
+        char const* str = ((char* const*)array->values)[i];
+        hash = hash_bytes(hash, str, strlen(str) + 1);
+        break;
+      }
+      case DATA_DATA:
+        hash = hash_data(hash, ((data_t* const*)array->values)[i]);
+        break;
+      case DATA_ARRAY:
+        hash = hash_array(hash, ((data_array_t* const*)array->values)[i]);
+        break;
+      default:
+        break;
+    }
+  }
+  return hash;
+}
+
+static uint32_t hash_data(uint32_t hash, data_t const* data) {
+  for (data_t const* d = data; d; d = d->next) {
+    hash = hash_bytes(hash, d->key, strlen(d->key) + 1);
+    switch (d->type) {
+      case DATA_INT:
+        hash = hash_bytes(hash, &d->value.v_int, sizeof(d->value.v_int));
+        break;
+      case DATA_DOUBLE:
+        hash = hash_bytes(hash, &d->value.v_dbl, sizeof(d->value.v_dbl));
+        break;
+      case DATA_STRING:
+        hash = hash_bytes(hash, d->value.v_ptr, strlen(d->value.v_ptr) + 1);
+        break;
+      case DATA_DATA:
+        hash = hash_data(hash, d->value.v_ptr);
+        break;
+      case DATA_ARRAY:
+        hash = hash_array(hash, d->value.v_ptr);
+        break;
+      default:
+        break;
+    }
+  }
+  return hash;
+}
+
+/// Check if the same decoder delivered the same fields within dedup_window,
+/// otherwise remember the message. rssi and duration are appended later and
+/// do not take part.
+static int is_duplicate_message(r_cfg_t* cfg, r_device_state* state, data_t* data) {
+  uint32_t hash = hash_bytes(2166136261u, &state->protocol_num,
+                             sizeof(state->protocol_num));
+  hash = hash_data(hash, data);
+
+  struct timeval now;
+  get_time_now(&now);
+  uint32_t now_ms = now.tv_sec * 1000 + now.tv_usec / 1000;
+
+  for (unsigned i = 0; i < DEDUP_CACHE_SIZE; ++i) {
+    if (dedup_cache[i].hash == hash && dedup_cache[i].time_ms &&
+        now_ms - dedup_cache[i].time_ms < (uint32_t)cfg->dedup_window) {
+      return 1;
+    }
+  }
+  dedup_cache[dedup_next].hash = hash;
+  dedup_cache[dedup_next].time_ms = now_ms | 1; // 0 marks unused
+  dedup_next = (dedup_next + 1) % DEDUP_CACHE_SIZE;
+  return 0;
+}
+
 /** Pass the data structure to all output handlers. Frees data afterwards. */
 
-void data_acquired_handler(r_device* r_dev, data_t* data) {
-  r_cfg_t* cfg = r_dev->output_ctx;
+void data_acquired_handler(r_device_state* state, data_t* data) {
+  r_device const* r_dev = state->device;
+  r_cfg_t* cfg = state->output_ctx;
+
+  output_lock();
+  // drop repeats before any conversion or formatting work
+  if (cfg->dedup_window > 0 && is_duplicate_message(cfg, state, data)) {
+    cfg->dedup_suppressed++;
+    output_unlock();
+    data_free(data);
+    return;
+  }
 
 #ifndef NDEBUG
   // check for undeclared csv fields
@@ -756,7 +1186,7 @@ void data_acquired_handler(r_device* r_dev, data_t* data) {
     }
     if (!found) {
       fprintf(stderr, "WARNING: Undeclared field \"%s\" in [%u] \"%s\"\n",
-              d->key, r_dev->protocol_num, r_dev->name);
+              d->key, state->protocol_num, r_dev->name);
     }
   }
 #endif
@@ -973,9 +1403,15 @@ void data_acquired_handler(r_device* r_dev, data_t* data) {
     data_output_print(output, data);
   }
 
+  pulse_data_t* pulse_data = cfg->demod->pulse_data;
   data_append(data, "protocol", "", DATA_STRING, r_dev->name, "rssi", "RSSI",
-              DATA_INT, cfg->demod->pulse_data.signalRssi, "duration", "",
-              DATA_INT, cfg->demod->pulse_data.signalDuration, NULL);
+              DATA_INT, pulse_data->signalRssi, "duration", "", DATA_INT,
+              pulse_data->signalDuration, "rssi_min", "", DATA_INT,
+              pulse_data->signalRssiMin, "rssi_max", "", DATA_INT,
+              pulse_data->signalRssiMax, "rssi_mean", "", DATA_DOUBLE,
+              roundf(pulse_data->rssi_db * 10) / 10.0, "snr", "SNR",
+              DATA_DOUBLE, roundf(pulse_data->snr_db * 10) / 10.0, "noise",
+              "Noise", DATA_INT, (int)pulse_data->noise_db, NULL);
   data_print_jsons(data, cfg->messageBuffer, cfg->bufferSize);
 #ifdef DEMOD_DEBUG
   logprintfLn(LOG_INFO, "data_output %s", cfg->messageBuffer);
@@ -984,6 +1420,7 @@ void data_acquired_handler(r_device* r_dev, data_t* data) {
   // callback to external function that receives message from device (
   // rtl_433_ESPCallBack )
   (cfg->callback)(cfg->messageBuffer);
+  output_unlock();
   data_free(data);
 }
 
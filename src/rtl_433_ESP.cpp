@@ -86,15 +86,12 @@ static unsigned long gapStart = micros();
  */
 static unsigned long signalEnd = micros();
 
-pulse_data_t* _pulseTrains;
-
 int rtl_433_ESP::messageCount = 0;
 int rtl_433_ESP::currentRssi = 0;
 int rtl_433_ESP::signalRssi = 0;
 int rtl_433_ESP::rssiThreshold = MINRSSI;
 bool rtl_433_ESP::_enabledReceiver = false;
-volatile uint8_t rtl_433_ESP::_actualPulseTrain = 0;
-uint8_t rtl_433_ESP::_avaiablePulseTrain = 0;
+pulse_data_t* volatile rtl_433_ESP::_actualPulseTrain = NULL;
 volatile unsigned long rtl_433_ESP::_lastChange = 0; // Timestamp of previous edge
 int rtl_433_ESP::rtlVerbose = 0;
 volatile int16_t rtl_433_ESP::_nrpulses;
@@ -104,6 +101,7 @@ volatile int16_t rtl_433_ESP::_nrpulses;
 int rtl_433_ESP::totalSignals = 0;
 int rtl_433_ESP::ignoredSignals = 0;
 int rtl_433_ESP::unparsedSignals = 0;
+int rtl_433_ESP::repeatSignals = 0;
 int signalRatio = 0;
 
 // RSSI Threshold and average calculation
@@ -113,7 +111,7 @@ int rtl_433_ESP::rssiThresholdDelta = RSSI_THRESHOLD;
 
 bool rtl_433_ESP::ookModulation = OOK_MODULATION; // Defaults to true
 
-int _totalRssi = 0;
+int32_t _noiseFloor = 0; // Noise floor average in 1/65536 dBm
 int _rssiCount = 0;
 
 int _noiseCount = 0; // Count of ticks while receiver is disabled
@@ -127,11 +125,37 @@ static byte receiverGpio = -1;
 
 static TaskHandle_t rtl_433_ReceiverHandle;
 
+/**
+ * Signal edges captured by interruptHandler and waiting for assemblePulses.
+ * Single producer / single consumer ring, _edgeHead is only written by the
+ * interrupt handler and _edgeTail only by rtl_433_ReceiverTask.
+ */
+typedef struct {
+  unsigned long time; // micros() at the edge
+  int8_t rssi; // currentRssi at the edge
+  uint8_t level; // receiver gpio level after the edge
+} edge_t;
+
+static_assert((EDGE_RING_SIZE & (EDGE_RING_SIZE - 1)) == 0,
+              "EDGE_RING_SIZE must be a power of 2");
+
+static edge_t _edges[EDGE_RING_SIZE];
+static volatile uint32_t _edgeHead = 0;
+static volatile uint32_t _edgeTail = 0;
+static volatile int _edgeOverflows = 0; // Edges dropped while the ring was full
+
+/**
+ * RSSI statistics of the pulse train being captured, sampled by
+ * rtl_433_ReceiverTask
+ */
+static int _trainRssiMin;
+static int _trainRssiMax;
+static long _trainRssiSum; // Sum of samples above rssiThreshold
+static int _trainRssiCount;
+
 /*----------------------------- End of variable initialization -----------------------------*/
 
 rtl_433_ESP::rtl_433_ESP() {
-  _pulseTrains = (pulse_data_t*)heap_caps_calloc(
-      RECEIVER_BUFFER_SIZE, sizeof(pulse_data_t), MALLOC_CAP_INTERNAL);
 }
 
 /**
@@ -333,71 +357,219 @@ void rtl_433_ESP::initReceiver(byte inputPin, float receiveFrequency) {
 }
 
 /**
- * @brief Is a signal available for decoding ?
+ * @brief Signal edge interrupt, queues the edge for assemblePulses
  * 
- * @return int - which pulse train
  */
-int rtl_433_ESP::receivePulseTrain() {
-  if (_pulseTrains[_avaiablePulseTrain].num_pulses > 0) {
-    uint8_t _currentTrain = _avaiablePulseTrain;
-    _avaiablePulseTrain = (_avaiablePulseTrain + 1) % RECEIVER_BUFFER_SIZE;
-    return _currentTrain;
+void ICACHE_RAM_ATTR rtl_433_ESP::interruptHandler() {
+  if (!_enabledReceiver || !receiveMode) {
+    _noiseCount++;
+    return;
+  }
+  const uint32_t head = _edgeHead;
+  if (head - _edgeTail >= EDGE_RING_SIZE) { // Ring is full, edge is dropped
+    _edgeOverflows++;
+    return;
+  }
+  edge_t* edge = &_edges[head & (EDGE_RING_SIZE - 1)];
+  edge->time = micros();
+  edge->level = digitalRead(receiverGpio);
+  edge->rssi = currentRssi < INT8_MIN ? INT8_MIN : currentRssi;
+  _edgeHead = head + 1; // Publish the edge once it is complete
+  if (head == _edgeTail) { // Wake rtl_433_ReceiverTask for the first edge
+    vTaskNotifyGiveFromISR(rtl_433_ReceiverHandle, NULL);
   }
-  return -1;
 }
 
 /**
- * @brief Main pulse receiver logic
- * 
+ * @brief Start RSSI statistics for a new pulse train
  */
-void ICACHE_RAM_ATTR rtl_433_ESP::interruptHandler() {
-  if (!_enabledReceiver || !receiveMode) {
-    _noiseCount++;
-    return;
+static void resetTrainRssi(int rssi) {
+  _trainRssiMin = rssi;
+  _trainRssiMax = rssi;
+  _trainRssiSum = 0;
+  _trainRssiCount = 0;
+}
+
+/**
+ * @brief Add a RSSI sample to the statistics of the current pulse train
+ */
+static void sampleTrainRssi(int rssi) {
+  if (rssi < _trainRssiMin) {
+    _trainRssiMin = rssi;
+  }
+  if (rssi > _trainRssiMax) {
+    _trainRssiMax = rssi;
+  }
+  if (rssi > rtl_433_ESP::rssiThreshold) {
+    _trainRssiSum += rssi;
+    _trainRssiCount++;
+  }
+}
+
+/**
+ * @brief Store the RSSI statistics and signal to noise ratio against the
+ * noise floor in a completed pulse train
+ */
+static void storeTrainRssi(pulse_data_t* rtl_pulses) {
+  rtl_pulses->signalRssiMin = _trainRssiMin;
+  rtl_pulses->signalRssiMax = _trainRssiMax;
+  rtl_pulses->rssi_db = _trainRssiCount ? (float)_trainRssiSum / _trainRssiCount : _trainRssiMax;
+  rtl_pulses->noise_db = rtl_433_ESP::averageRssi;
+  rtl_pulses->snr_db = rtl_pulses->rssi_db - rtl_pulses->noise_db;
+}
+
+/**
+ * @brief Index of the longest gap in the second half of a pulse train, the
+ * most likely boundary between two packets
+ *
+ * @param pulseTrain
+ * @param last - index of the last complete gap
+ */
+static unsigned int longestGap(pulse_data_t const* pulseTrain, unsigned int last) {
+  unsigned int longest = last;
+  for (unsigned int i = PD_MAX_PULSES / 2; i < last; i++) {
+    if (pulse_data_get_gap(pulseTrain, i) > pulse_data_get_gap(pulseTrain, longest)) {
+      longest = i;
+    }
+  }
+  return longest;
+}
+
+/**
+ * @brief Count a completed signal and check that it is worth decoding
+ *
+ * @param pulses - index of the pulse ended by the packet gap
+ * @param length - signal length in micros, without the packet gap
+ * @return true if the signal has more than PD_MIN_PULSES pulses and is longer
+ * than MINIMUM_SIGNAL_LENGTH, otherwise it is counted as ignored
+ */
+bool rtl_433_ESP::acceptSignal(unsigned int pulses, unsigned long length) {
+  totalSignals++;
+  if (pulses > PD_MIN_PULSES && length > MINIMUM_SIGNAL_LENGTH) {
+    return true;
   }
-  volatile pulse_data_t& pulseTrain = _pulseTrains[_actualPulseTrain];
-  volatile int* pulse = pulseTrain.pulse;
-  volatile int* gap = pulseTrain.gap;
+  ignoredSignals++;
+  return false;
+}
+
+/**
+ * @brief Pass the first pulses of the current train to the decoder while the
+ * signal is still being received, the remaining complete pulses are carried
+ * over to a new train
+ *
+ * @param count - number of pulses to decode, the last one ends with the
+ * packet gap
+ * @param edgeTime - time of the edge that ended the last gap
+ * @return true if the train was split, false if no free train is available
+ */
+bool rtl_433_ESP::splitPulseTrain(unsigned int count, unsigned long edgeTime) {
+  pulse_data_t* next = acquirePulseTrain();
+  if (!next) {
+    return false;
+  }
+  pulse_data_t* rtl_pulses = _actualPulseTrain;
+  const unsigned int carry = _nrpulses + 1 - count;
+  unsigned long duration = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    duration += pulse_data_get_pulse(rtl_pulses, i) + pulse_data_get_gap(rtl_pulses, i);
+  }
+  // The carried pulses are a new signal, measured from their first edge
+  signalStart = edgeTime - pulse_data_split(rtl_pulses, next, count, count + carry);
 #ifdef SIGNAL_RSSI
-  volatile int* rssi = pulseTrain.rssi;
+  memcpy(next->rssi, &rtl_pulses->rssi[count], carry * sizeof(next->rssi[0]));
+  memset(&rtl_pulses->rssi[count], 0, carry * sizeof(rtl_pulses->rssi[0]));
 #endif
+  _actualPulseTrain = next;
+  _nrpulses = carry;
+
+#ifdef DEMOD_DEBUG
+  logprintf(LOG_INFO, "Split signal length: %lu", duration);
+  alogprintf(LOG_INFO, ", pulses: %d", count);
+  alogprintfLn(LOG_INFO, ", carried over: %d", carry);
+#endif
+  const unsigned long length = duration - pulse_data_get_gap(rtl_pulses, count - 1);
+  if (acceptSignal(count - 1, length)) {
+    rtl_pulses->num_pulses = count;
+    rtl_pulses->signalDuration = length;
+    rtl_pulses->signalRssi = signalRssi;
+    storeTrainRssi(rtl_pulses);
+    messageCount++;
+    processSignal(rtl_pulses);
+  } else {
+    rtl_pulses->num_pulses = count;
+    releasePulseTrain(rtl_pulses);
+  }
+  signalRssi = currentRssi;
+  resetTrainRssi(currentRssi);
+  sampleTrainRssi(currentRssi);
+  return true;
+}
+
+/**
+ * @brief Main pulse receiver logic, turns queued edges into pulses and gaps
+ * 
+ */
+void rtl_433_ESP::assemblePulses() {
+  const uint32_t head = _edgeHead;
+  pulse_data_t* pulseTrain = _actualPulseTrain;
+  if (!pulseTrain) { // No free pulse train, signal is dropped
+    _edgeTail = head;
+    return;
+  }
 
-  const unsigned long now = micros();
-  const unsigned int duration = now - _lastChange;
+  for (uint32_t tail = _edgeTail; tail != head; tail++) {
+    const edge_t* edge = &_edges[tail & (EDGE_RING_SIZE - 1)];
+    const unsigned int duration = edge->time - _lastChange;
 
-  /* We first do some filtering (same as pilight BPF) */
+    /* We first do some filtering (same as pilight BPF) */
 
 #ifdef RF_CC1101
-  if (duration > MINIMUM_PULSE_LENGTH && currentRssi > rssiThreshold)
+    if (duration > MINIMUM_PULSE_LENGTH && edge->rssi > rssiThreshold)
 #else
-  if (duration > MINIMUM_PULSE_LENGTH) // SX127X RSSI Value drops for a 0 value,
-  // and the OOK floor compensates for this
+    if (duration > MINIMUM_PULSE_LENGTH) // SX127X RSSI Value drops for a 0 value,
+    // and the OOK floor compensates for this
 #endif
-  {
+    {
 #ifdef SIGNAL_RSSI
-    rssi[_nrpulses] = currentRssi;
+      pulseTrain->rssi[_nrpulses] = edge->rssi;
 #endif
-    if (!digitalRead(receiverGpio)) {
-      pulse[_nrpulses] = duration;
-
-      //      _nrpulses = (uint16_t)((_nrpulses + 1) % PD_MAX_PULSES);
-    } else {
-      if (pulse[_nrpulses] > 0) // Did we collect a + pulse ?
-      {
-        gap[_nrpulses] = duration;
+      if (!edge->level) {
+        pulse_data_set_pulse(pulseTrain, _nrpulses, duration);
 
-        _nrpulses = (uint16_t)((_nrpulses + 1) % PD_MAX_PULSES);
-      } else if (_nrpulses > 1) { // Have we received any data ?
-        // We received a random positive blib
-        gap[_nrpulses - 1] += duration;
+        //      _nrpulses = (uint16_t)((_nrpulses + 1) % PD_MAX_PULSES);
       } else {
-        gap[_nrpulses] = duration;
-
-        _nrpulses = (uint16_t)((_nrpulses + 1) % PD_MAX_PULSES);
+        if (pulseTrain->pulse[_nrpulses] > 0) // Did we collect a + pulse ?
+        {
+          pulse_data_set_gap(pulseTrain, _nrpulses, duration);
+
+          if (duration > packetResetLimit() &&
+              splitPulseTrain(_nrpulses + 1, edge->time)) {
+            // Packet is complete, it is decoded while capture continues
+            pulseTrain = _actualPulseTrain;
+          } else if (_nrpulses < PD_MAX_PULSES - 1) {
+            _nrpulses++;
+          } else if (splitPulseTrain(longestGap(pulseTrain, _nrpulses) + 1,
+                                     edge->time)) {
+            // Train is full, decode up to the longest recent gap and carry
+            // the rest over
+            pulseTrain = _actualPulseTrain;
+          }
+        } else if (_nrpulses > 1) { // Have we received any data ?
+          // We received a random positive blib
+          pulse_data_set_gap(pulseTrain, _nrpulses - 1,
+                             pulse_data_get_gap(pulseTrain, _nrpulses - 1) + duration);
+        } else {
+          pulse_data_set_gap(pulseTrain, _nrpulses, duration);
+
+          if (_nrpulses < PD_MAX_PULSES - 1) {
+            _nrpulses++;
+          }
+        }
       }
+      _lastChange = edge->time;
     }
-    _lastChange = now;
   }
+  _edgeTail = head; // Hand the slots back to interruptHandler
 }
 
 /**
@@ -405,14 +577,15 @@ void ICACHE_RAM_ATTR rtl_433_ESP::interruptHandler() {
  * 
  */
 void rtl_433_ESP::resetReceiver() {
-  for (unsigned int i = 0; i < RECEIVER_BUFFER_SIZE; i++) {
-    _pulseTrains[i].num_pulses = 0;
+  if (_actualPulseTrain) {
+    _actualPulseTrain->num_pulses = _nrpulses + 1;
+    releasePulseTrain(_actualPulseTrain);
   }
-  _avaiablePulseTrain = 0;
-  _actualPulseTrain = 0;
+  _actualPulseTrain = acquirePulseTrain();
   _nrpulses = 0;
 
   receiveMode = false;
+  _edgeTail = _edgeHead;
   signalStart = micros();
 }
 
@@ -439,7 +612,8 @@ void rtl_433_ESP::disableReceiver() {
 }
 
 /**
- * @brief watch for completed signals being received, and pass to decoder logic
+ * @brief receiver housekeeping, completed signals are passed to the decoder
+ * logic by rtl_433_ReceiverTask
  * 
  */
 void rtl_433_ESP::loop() {
@@ -456,42 +630,6 @@ void rtl_433_ESP::loop() {
     } // workaround for a deaf CC1101
 #endif
 
-    int _receiveTrain = receivePulseTrain();
-    if (_receiveTrain != -1) // Is there anything to receive ?
-    {
-#ifdef MEMORY_DEBUG
-      logprintfLn(LOG_INFO, "Pre copy out of train: %d", ESP.getFreeHeap());
-#endif
-      pulse_data_t* rtl_pulses = (pulse_data_t*)heap_caps_calloc(1, sizeof(pulse_data_t), MALLOC_CAP_INTERNAL);
-      memcpy(rtl_pulses, (char*)&_pulseTrains[_receiveTrain], sizeof(pulse_data_t));
-      _pulseTrains[_receiveTrain].num_pulses = 0; // Make pulse train available for next train
-      for (int x = 0; x < PD_MAX_PULSES; x++) {
-        _pulseTrains[_receiveTrain].pulse[x] = 0;
-        _pulseTrains[_receiveTrain].gap[x] = 0;
-#ifdef SIGNAL_RSSI
-        _pulseTrains[_receiveTrain].rssi[x] = 0;
-#endif
-      }
-#ifdef MEMORY_DEBUG
-      logprintfLn(LOG_INFO, "Post copy out of train: %d", ESP.getFreeHeap());
-#endif
-
-      if (rtl_pulses->num_pulses > PD_MIN_PULSES) {
-        processSignal(rtl_pulses); // send received signal for decoding
-      } else {
-        ignoredSignals++;
-#ifdef MEMORY_DEBUG
-        logprintfLn(LOG_INFO, "Pre free copy out of train: %d",
-                    ESP.getFreeHeap());
-#endif
-        free(rtl_pulses);
-#ifdef MEMORY_DEBUG
-        logprintfLn(LOG_INFO, "Post free copy out of train: %d",
-                    ESP.getFreeHeap());
-#endif
-      }
-    }
-
     // Adjust RegOokFix threshold
 
     if ((totalSignals % 100) == 0 && totalSignals != 0) {
@@ -535,38 +673,53 @@ void rtl_433_ESP::loop() {
 void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
   for (;;) {
     if (_enabledReceiver) {
-      // Calculate average RSSI signal level in environment
+      // Track the noise floor with an exponential moving average, samples
+      // taken while receiving a signal would inflate it and are skipped
 
       currentRssi = _getRSSI();
-      _rssiCount++;
-      _totalRssi += currentRssi;
-
-      if (_rssiCount > RSSI_SAMPLES) // Adjust RSSI Signal Threshold
-      {
-        averageRssi = _totalRssi / _rssiCount;
+      if (!receiveMode) {
+        if (_rssiCount == 0) {
+          _noiseFloor = currentRssi * 65536;
+        }
+        _noiseFloor += (currentRssi * 65536 - _noiseFloor) / RSSI_SAMPLES;
+        averageRssi = (_noiseFloor + 32768) >> 16;
 
 #ifdef AUTORSSITHRESHOLD
         rssiThreshold = averageRssi + rssiThresholdDelta;
-        logprintfLn(LOG_DEBUG,
-                    "Average RSSI Signal %d dbm, adjusted RSSI Threshold %d, "
-                    "samples %d",
-                    averageRssi, rssiThreshold, RSSI_SAMPLES);
 #endif
 
-        _totalRssi = 0;
-        _rssiCount = 0;
+        if (++_rssiCount % RSSI_SAMPLES == 0) {
+#ifdef AUTORSSITHRESHOLD
+          logprintfLn(LOG_DEBUG,
+                      "Average RSSI Signal %d dbm, adjusted RSSI Threshold %d, "
+                      "samples %d",
+                      averageRssi, rssiThreshold, RSSI_SAMPLES);
+#endif
+          _rssiCount = RSSI_SAMPLES;
+        }
+      }
+
+      if (receiveMode) {
+        sampleTrainRssi(currentRssi);
+        assemblePulses();
       }
 
       if (currentRssi > rssiThreshold) // A signal is present
       {
         if (!receiveMode) {
+          if (!_actualPulseTrain) { // Retry, a train may have been released
+            _actualPulseTrain = acquirePulseTrain();
+          }
+          _edgeTail = _edgeHead; // Discard edges left over from the last signal
+          _lastChange = micros();
           receiveMode = true;
           signalStart = micros();
 #ifdef ONBOARD_LED
           digitalWrite(ONBOARD_LED, HIGH);
 #endif
           signalRssi = currentRssi;
-          _lastChange = micros();
+          resetTrainRssi(currentRssi);
+          sampleTrainRssi(currentRssi);
 
           if (_noiseCount > 100) {
 #ifdef AUTOOOKFIX
@@ -588,18 +741,12 @@ void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
         }
         signalEnd = micros();
       }
-#if defined(RF_SX1276) || defined(RF_SX1278)
-      // If we received a signal but had a minor drop in strength keep the
-      // receiver running for an additional 150,000
-      else if (micros() - signalEnd < MINIMUM_SIGNAL_LENGTH)
-#else
-      // If we received a signal but had a minor drop in strength keep the
-      // receiver running for an additional 40,000
-      else if (micros() - signalEnd < MINIMUM_SIGNAL_LENGTH && micros() - signalStart > 30000)
-      // else if (micros() - signalEnd < PD_MAX_GAP_MS)
-#endif
-      {
-        // skip over signal drop outs
+      // The packet ends once the gap since the last edge exceeds the reset
+      // limit of every decoder, RSSI only keeps a carrier without edges open
+      // and ends a signal that stays quiet but keeps toggling on noise
+      else if (receiveMode && micros() - _lastChange < packetResetLimit() &&
+               micros() - signalEnd < packetResetLimit()) {
+        // skip over gaps within a packet
       } else // A signal is not present
       {
         if (receiveMode) // Complete reception of a signal
@@ -608,31 +755,29 @@ void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
           digitalWrite(ONBOARD_LED, LOW);
 #endif
           receiveMode = false;
-          totalSignals++;
-          if ((_nrpulses > PD_MIN_PULSES) &&
-              ((signalEnd - signalStart) >
-               MINIMUM_SIGNAL_LENGTH)) // Minimum signal length of MINIMUM_SIGNAL_LENGTH MS
-          {
-            _pulseTrains[_actualPulseTrain].num_pulses = _nrpulses + 1;
-            _pulseTrains[_actualPulseTrain].signalDuration =
-                signalEnd - signalStart;
-            _pulseTrains[_actualPulseTrain].signalRssi = signalRssi;
+          assemblePulses(); // Edges captured before receiveMode was cleared
+          pulse_data_t* rtl_pulses = _actualPulseTrain;
+          if (acceptSignal(_nrpulses, signalEnd - signalStart) && rtl_pulses) {
+            rtl_pulses->num_pulses = _nrpulses + 1;
+            rtl_pulses->signalDuration = signalEnd - signalStart;
+            rtl_pulses->signalRssi = signalRssi;
+            storeTrainRssi(rtl_pulses);
 #ifdef DEMOD_DEBUG
             logprintf(LOG_INFO, "Signal length: %lu",
-                      _pulseTrains[_actualPulseTrain].signalDuration);
+                      rtl_pulses->signalDuration);
             alogprintf(LOG_INFO, ", Gap length: %lu", signalStart - gapStart);
-            alogprintf(LOG_INFO, ", Signal RSSI: %d",
-                       _pulseTrains[_actualPulseTrain].signalRssi);
-            alogprintf(LOG_INFO, ", train: %d", _actualPulseTrain);
+            alogprintf(LOG_INFO, ", Signal RSSI: %d", rtl_pulses->signalRssi);
+            alogprintf(LOG_INFO, ", free trains: %d", freePulseTrains());
             alogprintf(LOG_INFO, ", messageCount: %d", messageCount);
             alogprintfLn(LOG_INFO, ", pulses: %d", _nrpulses);
 #endif
             messageCount++;
             gapStart = micros();
-            _actualPulseTrain = (_actualPulseTrain + 1) % RECEIVER_BUFFER_SIZE;
+            // Hand the train over to the decoder and continue capture in a free one
+            _actualPulseTrain = acquirePulseTrain();
             _nrpulses = 0;
+            processSignal(rtl_pulses);
           } else {
-            ignoredSignals++;
 #ifdef DEMOD_DEBUG
             if (micros() - signalStart > 1000) {
               logprintf(LOG_INFO, "Ignored Signal length: %lu",
@@ -648,6 +793,11 @@ void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
               gapStart = micros();
             }
 #endif
+            if (rtl_pulses) { // Clear what was captured and reuse the train
+              rtl_pulses->num_pulses = _nrpulses + 1;
+              releasePulseTrain(rtl_pulses);
+              _actualPulseTrain = acquirePulseTrain();
+            }
             _nrpulses = 0;
           }
 #ifdef MEMORY_DEBUG
@@ -657,7 +807,20 @@ void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
         }
       }
     }
-    vTaskDelay(1);
+    // While receiving, sleep until the next edge is queued or the packet could
+    // have ended, otherwise sample the RSSI for a signal every tick
+    TickType_t wait = 1;
+    if (_enabledReceiver && receiveMode) {
+      unsigned long quiet = micros() - _lastChange;
+      if (micros() - signalEnd > quiet) {
+        quiet = micros() - signalEnd;
+      }
+      if (quiet < packetResetLimit()) {
+        wait = ((packetResetLimit() - quiet) / 1000 + portTICK_PERIOD_MS) /
+               portTICK_PERIOD_MS;
+      }
+    }
+    ulTaskNotifyTake(pdTRUE, wait);
   }
 }
 
@@ -723,6 +886,42 @@ void rtl_433_ESP::setDebug(int debug) {
   logprintfLn(LOG_INFO, "Setting rtl_433 debug to: %d", rtlVerbose);
 }
 
+/**
+ * @brief Enable a device decoder between signals
+ *
+ * @param protocol - protocol number
+ */
+bool rtl_433_ESP::enableDecoder(int protocol) {
+  return changeDecoder(protocol, true);
+}
+
+bool rtl_433_ESP::enableDecoder(const char* name) {
+  int protocol = decoderProtocol(name);
+  return protocol >= 0 && changeDecoder(protocol, true);
+}
+
+/**
+ * @brief Disable a device decoder between signals
+ *
+ * @param protocol - protocol number
+ */
+bool rtl_433_ESP::disableDecoder(int protocol) {
+  return changeDecoder(protocol, false);
+}
+
+bool rtl_433_ESP::disableDecoder(const char* name) {
+  int protocol = decoderProtocol(name);
+  return protocol >= 0 && changeDecoder(protocol, false);
+}
+
+bool rtl_433_ESP::enableAllDecoders() {
+  return changeDecoder(-1, true);
+}
+
+bool rtl_433_ESP::disableAllDecoders() {
+  return changeDecoder(-1, false);
+}
+
 /**
  * @brief Send RTL_433_ESP status to serial port and client. Also send to serial port transceiver status.
  * 
@@ -734,15 +933,20 @@ void rtl_433_ESP::getStatus() {
             signalStart - gapStart);
   alogprintf(LOG_INFO, ", Modulation: %s", ookModulation ? "OOK" : "FSK");
   alogprintf(LOG_INFO, ", Signal RSSI: %d", signalRssi);
-  alogprintf(LOG_INFO, ", train: %d", _actualPulseTrain);
+  alogprintf(LOG_INFO, ", freeTrains: %d", freePulseTrains());
+  alogprintf(LOG_INFO, ", edgeOverflows: %d", _edgeOverflows);
   alogprintf(LOG_INFO, ", messageCount: %d", messageCount);
   alogprintf(LOG_INFO, ", totalSignals: %d", totalSignals);
   alogprintf(LOG_INFO, ", signalRatio: %d", signalRatio);
   alogprintf(LOG_INFO, ", ignoredSignals: %d", ignoredSignals);
   alogprintf(LOG_INFO, ", unparsedSignals: %d", unparsedSignals);
+  alogprintf(LOG_INFO, ", repeatSignals: %d", repeatSignals);
+  alogprintf(LOG_INFO, ", duplicateMessages: %u", duplicateMessages());
+  alogprintf(LOG_INFO, ", decoders: %d", enabledDecoders());
   alogprintf(LOG_INFO, ", _enabledReceiver: %d", _enabledReceiver);
   alogprintf(LOG_INFO, ", receiveMode: %d", receiveMode);
   alogprintf(LOG_INFO, ", currentRssi: %d", currentRssi);
+  alogprintf(LOG_INFO, ", noiseFloor: %d", averageRssi);
   alogprintf(LOG_INFO, ", rssiThreshold: %d", rssiThreshold);
   alogprintf(LOG_INFO, ", StackHWM: %d", uxTaskGetStackHighWaterMark(NULL));
   alogprintf(LOG_INFO, ", RTL_HWM: %d", uxTaskGetStackHighWaterMark(rtl_433_ReceiverHandle));
@@ -765,12 +969,16 @@ void rtl_433_ESP::getStatus() {
                "RTLOOKThresh",    "", DATA_INT,     OokFixedThreshold,
 #endif
 
-                "train",          "", DATA_INT, _actualPulseTrain,
+                "freeTrains",     "", DATA_INT, freePulseTrains(),
+                "edgeOverflows",  "", DATA_INT, _edgeOverflows,
                 "RTLCnt",         "", DATA_INT, messageCount,
                 "totalSignals",   "", DATA_INT, totalSignals,
                 "signalRatio",    "", DATA_INT, signalRatio,
                 "ignoredSignals", "", DATA_INT, ignoredSignals,
                 "unparsedSignals", "", DATA_INT, unparsedSignals,
+                "repeatSignals",  "", DATA_INT, repeatSignals,
+                "duplicateMessages", "", DATA_INT, duplicateMessages(),
+                "decoders",       "", DATA_INT, enabledDecoders(),
                 "StackHWM",       "", DATA_INT, uxTaskGetStackHighWaterMark(NULL),
                 "RTL_HWM",        "", DATA_INT, uxTaskGetStackHighWaterMark(rtl_433_ReceiverHandle),
                 "DCD_HWM",        "", DATA_INT, uxTaskGetStackHighWaterMark(rtl_433_DecoderHandle),
@@ -59,9 +59,9 @@
 #  define DEAF_WORKAROUND
 #endif
 
-// Number of rssi results to collect for average calculation
+// Time constant in rssi samples of the noise floor average
 #ifndef RSSI_SAMPLES
-#  define RSSI_SAMPLES 50000
+#  define RSSI_SAMPLES 2000
 #endif
 
 //  Amount to add to average RSSI to determine if a signal is present
@@ -76,11 +76,31 @@
 
 // #define AUTOOOKFIX true      // Has shown to be problematic
 
-// Pulse train buffer count
-#define RECEIVER_BUFFER_SIZE 2
+// Pulse train buffer count, slots are shared between capture and decoding
+#ifndef RECEIVER_BUFFER_SIZE
+#  define RECEIVER_BUFFER_SIZE 6
+#endif
 
 // #define MAXPULSESTREAMLENGTH 750 // Pulse train buffer size
 
+// Number of signal edges buffered between the interrupt handler and the
+// receiver task, must be a power of 2
+#ifndef EDGE_RING_SIZE
+#  define EDGE_RING_SIZE 256
+#endif
+
+// Window in milliseconds to skip decoding a repeat of an already decoded
+// signal, 0 to decode every signal. A skipped repeat is not published again
+#ifndef REPEAT_WINDOW
+#  define REPEAT_WINDOW 0
+#endif
+
+// Window in milliseconds to drop a decoded message identical to one already
+// delivered, 0 to deliver every message
+#ifndef MESSAGE_DEDUP_WINDOW
+#  define MESSAGE_DEDUP_WINDOW 0
+#endif
+
 // Set to false to enable FSK demodulators ( Experimental )
 #ifndef OOK_MODULATION
 #  define OOK_MODULATION true
@@ -230,6 +250,8 @@ typedef void (*rtl_433_ESPCallBack)(char* message);
 typedef std::function<void(const uint16_t* pulses, size_t length)>
     PulseTrainCallBack;
 
+typedef struct pulse_data pulse_data_t; // see pulse_data.h
+
 class rtl_433_ESP {
 public:
   /**
@@ -307,6 +329,25 @@ public:
 
   static void getModuleStatus();
 
+  /**
+   * Enable or disable a device decoder at runtime, by protocol number ( the
+   * index in the device list of signalDecoder.cpp ) or by name. The change is
+   * applied by the decoder task once the signal it is decoding is done.
+   *
+   * Returns false if the decoder is unknown or too many changes are pending
+   */
+  static bool enableDecoder(int protocol);
+  static bool enableDecoder(const char* name);
+  static bool disableDecoder(int protocol);
+  static bool disableDecoder(const char* name);
+
+  /**
+   * Enable the device decoders enabled at startup, or disable every device
+   * decoder, e.g. disable all and then enable only those of your own sensors
+   */
+  static bool enableAllDecoders();
+  static bool disableAllDecoders();
+
   /**
    * Number of messages received since most recent device startup
    */
@@ -329,6 +370,9 @@ public:
 
   static int rssiThresholdDelta;
 
+  /**
+   * Noise floor, moving average of rssi between signals
+   */
   static int averageRssi;
 
   /**
@@ -357,6 +401,11 @@ public:
   static int ignoredSignals;
   static int unparsedSignals;
 
+  /**
+   * Signals skipped as a repeat of a signal decoded within REPEAT_WINDOW
+   */
+  static int repeatSignals;
+
   static uint8_t OokFixedThreshold;
 
   /*----------------------------- Future features -----------------------------*/
@@ -386,12 +435,22 @@ private:
 
   /**
    * interruptHandler is called on every change in the input
-   * signal. If RcPilight::initReceiver is called with interrupt <0,
-   * you have to call interruptHandler() yourself. (Or use
-   * InterruptChain)
+   * signal. It only timestamps the edge and queues it for
+   * assemblePulses().
    */
   static void interruptHandler();
 
+  /**
+   * Drain the edges queued by interruptHandler, filter them and turn them
+   * into pulses and gaps of the current pulse train. Called from
+   * rtl_433_ReceiverTask.
+   */
+  static void assemblePulses();
+
+  static bool acceptSignal(unsigned int pulses, unsigned long length);
+
+  static bool splitPulseTrain(unsigned int count, unsigned long edgeTime);
+
   /**
    * interruptHandler used to calibrate OOK floor threshold
    */
@@ -406,20 +465,16 @@ private:
 
   static int _getRSSI();
 
-  /**
-   * Get last received PulseTrain.
-   * Returns: last PulseTrain or 0 if not available
-   */
-  static int receivePulseTrain();
-
   /**
    * _enabledReceiver: If true, monitoring and decoding is enabled.
    * If false, interruptHandler will return immediately.
    */
   static bool _enabledReceiver;
-  // static volatile pulse_data_t _pulseTrains[];
-  static volatile uint8_t _actualPulseTrain;
-  static uint8_t _avaiablePulseTrain;
+  /**
+   * _actualPulseTrain: pulse train slot currently being captured into,
+   * NULL while every slot is queued for or busy decoding.
+   */
+  static pulse_data_t* volatile _actualPulseTrain;
   static volatile unsigned long _lastChange;
   static volatile int16_t _nrpulses;
   static int16_t _interrupt;
@@ -53,6 +53,214 @@ r_cfg_t g_cfg; // Global config object
 TaskHandle_t rtl_433_DecoderHandle;
 static QueueHandle_t rtl_433_Queue;
 
+/**
+ * Fixed pool of pulse trains, ownership moves by pointer from capture to
+ * rtl_433_Queue, to the decoder, and back to rtl_433_FreeQueue
+ */
+static pulse_data_t* rtl_433_PulseTrains;
+static QueueHandle_t rtl_433_FreeQueue;
+
+#ifndef DECODER_CHANGES
+#  define DECODER_CHANGES 16
+#endif
+
+/**
+ * Decoder enable / disable request, see changeDecoder()
+ */
+typedef struct decoder_change {
+  int protocol; // index in cfg->devices, -1 for all decoders
+  bool enable;
+} decoder_change_t;
+
+/**
+ * Requests from other tasks, applied by the decoder task between pulse trains
+ */
+static QueueHandle_t rtl_433_ChangeQueue;
+
+/**
+ * Wakes the decoder task for a pulse train on rtl_433_Queue or a change on
+ * rtl_433_ChangeQueue, whichever arrives first
+ */
+static QueueSetHandle_t rtl_433_DecoderSet;
+
+/**
+ * Number of registered decoders, kept by the decoder task for other tasks
+ */
+static volatile int rtl_433_EnabledDecoders = 0;
+
+#if REPEAT_WINDOW > 0
+#  define REPEAT_HISTORY 4
+
+/**
+ * Fingerprints of the most recently decoded pulse trains
+ */
+static uint32_t rtl_433_RepeatPrint[REPEAT_HISTORY];
+static unsigned long rtl_433_RepeatTime[REPEAT_HISTORY];
+static int rtl_433_RepeatNext = 0;
+
+/**
+ * Fingerprint of a pulse train that tolerates timing jitter. Every pulse and
+ * gap is reduced to shorter or longer than the mean of the train, the means
+ * themselves only contribute their bit length.
+ */
+static uint32_t trainFingerprint(pulse_data_t const* rtl_pulses) {
+  const unsigned int num = rtl_pulses->num_pulses;
+  if (num < 2) {
+    return 0;
+  }
+  // The last gap is the end of packet gap, leave it out
+  unsigned long pulseSum = 0;
+  unsigned long gapSum = 0;
+  for (unsigned int i = 0; i < num; i++) {
+    pulseSum += pulse_data_get_pulse(rtl_pulses, i);
+    if (i < num - 1) {
+      gapSum += pulse_data_get_gap(rtl_pulses, i);
+    }
+  }
+  const int pulseMean = pulseSum / num;
+  const int gapMean = gapSum / (num - 1);
+
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  hash = (hash ^ num) * 16777619u;
+  hash = (hash ^ (32 - __builtin_clz(pulseMean | 1))) * 16777619u;
+  hash = (hash ^ (32 - __builtin_clz(gapMean | 1))) * 16777619u;
+  for (unsigned int i = 0; i < num - 1; i++) {
+    unsigned int symbol = (pulse_data_get_pulse(rtl_pulses, i) > pulseMean) |
+                          (pulse_data_get_gap(rtl_pulses, i) > gapMean) << 1;
+    hash = (hash ^ symbol) * 16777619u;
+  }
+  return hash;
+}
+
+/**
+ * Was a pulse train with this fingerprint decoded within REPEAT_WINDOW
+ */
+static bool decodedRecently(uint32_t fingerprint) {
+  for (int i = 0; i < REPEAT_HISTORY; i++) {
+    if (rtl_433_RepeatTime[i] && rtl_433_RepeatPrint[i] == fingerprint &&
+        millis() - rtl_433_RepeatTime[i] < REPEAT_WINDOW) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Remember the fingerprint of a decoded pulse train
+ */
+static void rememberDecoded(uint32_t fingerprint) {
+  rtl_433_RepeatPrint[rtl_433_RepeatNext] = fingerprint;
+  rtl_433_RepeatTime[rtl_433_RepeatNext] = millis() | 1; // 0 marks unused
+  rtl_433_RepeatNext = (rtl_433_RepeatNext + 1) % REPEAT_HISTORY;
+}
+#endif
+
+/**
+ * Gap in micros that ends a packet, see updateResetLimit()
+ */
+static unsigned long rtl_433_ResetLimit = PD_MAX_GAP_MS * 1000;
+
+/**
+ * Set the end of packet gap to the largest reset_limit of the registered
+ * decoders, so every decoder sees its repeated rows in one packet. Bounded by
+ * PD_MIN_GAP_MS and PD_MAX_GAP_MS like the rtl_433 pulse detector.
+ */
+static void updateResetLimit(r_cfg_t* cfg) {
+  float resetLimit = PD_MIN_GAP_MS * 1000;
+  for (void** iter = cfg->demod->r_devs.elems; iter && *iter; ++iter) {
+    float limit = ((r_device_state*)*iter)->device->reset_limit;
+    if (limit > resetLimit) {
+      resetLimit = limit;
+    }
+  }
+  if (resetLimit > PD_MAX_GAP_MS * 1000) {
+    resetLimit = PD_MAX_GAP_MS * 1000;
+  }
+  rtl_433_ResetLimit = resetLimit;
+#ifdef DEMOD_DEBUG
+  logprintfLn(LOG_INFO, "End of packet gap: %lu", rtl_433_ResetLimit);
+#endif
+}
+
+/**
+ * Registered state of a decoder in the device list, NULL if not enabled
+ */
+static r_device_state* registeredDecoder(r_cfg_t* cfg, int protocol) {
+  for (void** iter = cfg->demod->r_devs.elems; iter && *iter; ++iter) {
+    r_device_state* state = (r_device_state*)*iter;
+    if (state->protocol_num == (unsigned)protocol) {
+      return state;
+    }
+  }
+  return NULL;
+}
+
+#ifndef RTL_VERBOSE
+#  define RTL_VERBOSE -1
+#endif
+
+#define DECODER_ARG_SIZE 4
+
+/**
+ * Copy the registration arg of a decoder into arg, a fresh copy for every
+ * registration as create_fn may tokenize it. Used at startup and when a
+ * decoder is enabled again, so it keeps its verbosity and parameters.
+ *
+ * @return arg, or NULL if the decoder takes no arg
+ */
+static char* decoderArg(int protocol, char arg[DECODER_ARG_SIZE]) {
+  if (RTL_VERBOSE && protocol == RTL_VERBOSE) {
+    strncpy(arg, "vvv", DECODER_ARG_SIZE);
+    return arg;
+  }
+  return NULL;
+}
+
+/**
+ * Apply the queued decoder changes. Only called by the decoder task between
+ * pulse trains, so no decoder is running while the dispatch lists are rebuilt.
+ */
+static void applyDecoderChanges(r_cfg_t* cfg) {
+  decoder_change_t change;
+  bool changed = false;
+  while (xQueueReceive(rtl_433_ChangeQueue, &change, 0) == pdTRUE) {
+    for (int i = 0; i < cfg->num_r_devices; i++) {
+      if (change.protocol >= 0 && change.protocol != i) {
+        continue;
+      }
+      if (change.protocol < 0 && change.enable &&
+          cfg->devices[i]->disabled > 0) {
+        continue; // all means all enabled by default, as at startup
+      }
+      bool registered = registeredDecoder(cfg, i) != NULL;
+      if (change.enable && !registered) {
+        char arg[DECODER_ARG_SIZE];
+        register_protocol(cfg, cfg->devices[i], decoderArg(i, arg));
+        changed = true;
+      } else if (!change.enable && registered) {
+        unregister_protocol(cfg, cfg->devices[i]);
+        changed = true;
+      }
+    }
+    if (change.protocol >= 0) {
+      logprintfLn(LOG_INFO, "Decoder [%d] %s %s", change.protocol,
+                  cfg->devices[change.protocol]->name,
+                  change.enable ? "enabled" : "disabled");
+    } else {
+      logprintfLn(LOG_INFO, "All decoders %s",
+                  change.enable ? "enabled" : "disabled");
+    }
+  }
+  if (changed) {
+    updateResetLimit(cfg);
+    rtl_433_EnabledDecoders = cfg->demod->r_devs.len;
+#ifdef DEMOD_DEBUG
+    logprintfLn(LOG_INFO, "# of device(s) enabled %d", rtl_433_EnabledDecoders);
+#endif
+  }
+}
+
 void rtlSetup() {
   r_cfg_t* cfg = &g_cfg;
 
@@ -68,12 +276,14 @@ void rtlSetup() {
                 ESP.getFreeHeap());
 #endif
     cfg->conversion_mode = CONVERT_SI; // Default all output to Celsius
+    cfg->dedup_window = MESSAGE_DEDUP_WINDOW;
     if (rtl_433_ESP::ookModulation) {
       cfg->num_r_devices = NUMOF_OOK_DEVICES;
     } else {
       cfg->num_r_devices = NUMOF_FSK_DEVICES;
     }
-    cfg->devices = (r_device*)calloc(cfg->num_r_devices, sizeof(r_device));
+    // just the pointers, the decoders stay in flash
+    cfg->devices = (r_device const**)calloc(cfg->num_r_devices, sizeof(*cfg->devices));
     if (!cfg->devices)
       FATAL_CALLOC("cfg->devices");
 
@@ -86,285 +296,285 @@ void rtlSetup() {
   // This is a generated fragment from tools/update_rtl_433_devices.sh
 
   if (rtl_433_ESP::ookModulation) {
-    memcpy(&cfg->devices[0], &abmt, sizeof(r_device));
-    memcpy(&cfg->devices[1], &acurite_rain_896, sizeof(r_device));
-    memcpy(&cfg->devices[2], &acurite_th, sizeof(r_device));
-    memcpy(&cfg->devices[3], &acurite_txr, sizeof(r_device));
-    memcpy(&cfg->devices[4], &acurite_986, sizeof(r_device));
-    memcpy(&cfg->devices[5], &acurite_606, sizeof(r_device));
-    memcpy(&cfg->devices[6], &acurite_00275rm, sizeof(r_device));
-    memcpy(&cfg->devices[7], &acurite_590tx, sizeof(r_device));
-    memcpy(&cfg->devices[8], &acurite_01185m, sizeof(r_device));
-    memcpy(&cfg->devices[9], &advent_doorbell, sizeof(r_device));
-    memcpy(&cfg->devices[10], &akhan_100F14, sizeof(r_device));
-    memcpy(&cfg->devices[11], &alectov1, sizeof(r_device));
-    memcpy(&cfg->devices[12], &ambient_weather, sizeof(r_device));
-    memcpy(&cfg->devices[13], &ambientweather_tx8300, sizeof(r_device));
-    memcpy(&cfg->devices[14], &atech_ws308, sizeof(r_device));
-    memcpy(&cfg->devices[15], &auriol_4ld5661, sizeof(r_device));
-    memcpy(&cfg->devices[16], &auriol_aft77b2, sizeof(r_device));
-    memcpy(&cfg->devices[17], &auriol_afw2a1, sizeof(r_device));
-    memcpy(&cfg->devices[18], &auriol_ahfl, sizeof(r_device));
-    memcpy(&cfg->devices[19], &auriol_hg02832, sizeof(r_device));
-    memcpy(&cfg->devices[20], &baldr_rain, sizeof(r_device));
-    memcpy(&cfg->devices[21], &blyss, sizeof(r_device));
-    memcpy(&cfg->devices[22], &brennenstuhl_rcs_2044, sizeof(r_device));
-    memcpy(&cfg->devices[23], &bresser_3ch, sizeof(r_device));
-    memcpy(&cfg->devices[24], &bresser_st1005h, sizeof(r_device));
-    memcpy(&cfg->devices[25], &bt_rain, sizeof(r_device));
-    memcpy(&cfg->devices[26], &burnhardbbq, sizeof(r_device));
-    memcpy(&cfg->devices[27], &calibeur_RF104, sizeof(r_device));
-    memcpy(&cfg->devices[28], &cardin, sizeof(r_device));
-    memcpy(&cfg->devices[29], &celsia_czc1, sizeof(r_device));
-    memcpy(&cfg->devices[30], &chuango, sizeof(r_device));
-    memcpy(&cfg->devices[31], &cmr113, sizeof(r_device));
-    memcpy(&cfg->devices[32], &companion_wtr001, sizeof(r_device));
-    memcpy(&cfg->devices[33], &cotech_36_7959, sizeof(r_device));
-    memcpy(&cfg->devices[34], &digitech_xc0324, sizeof(r_device));
-    memcpy(&cfg->devices[35], &dish_remote_6_3, sizeof(r_device));
-    memcpy(&cfg->devices[36], &dooya_curtain, sizeof(r_device));
-    memcpy(&cfg->devices[37], &dsc_security, sizeof(r_device));
-    memcpy(&cfg->devices[38], &dsc_security_ws4945, sizeof(r_device));
-    memcpy(&cfg->devices[39], &ecowitt, sizeof(r_device));
-    memcpy(&cfg->devices[40], &eurochron_efth800, sizeof(r_device));
-    memcpy(&cfg->devices[41], &elro_db286a, sizeof(r_device));
-    memcpy(&cfg->devices[42], &elv_em1000, sizeof(r_device));
-    memcpy(&cfg->devices[43], &elv_ws2000, sizeof(r_device));
-    memcpy(&cfg->devices[44], &emos_e6016, sizeof(r_device));
-    memcpy(&cfg->devices[45], &emos_e6016_rain, sizeof(r_device));
-    memcpy(&cfg->devices[46], &enocean_erp1, sizeof(r_device));
-    memcpy(&cfg->devices[47], &ert_idm, sizeof(r_device));
-    memcpy(&cfg->devices[48], &ert_netidm, sizeof(r_device));
-    memcpy(&cfg->devices[49], &ert_scm, sizeof(r_device));
-    memcpy(&cfg->devices[50], &esa_energy, sizeof(r_device));
-    memcpy(&cfg->devices[51], &esperanza_ews, sizeof(r_device));
-    memcpy(&cfg->devices[52], &eurochron, sizeof(r_device));
-    memcpy(&cfg->devices[53], &fineoffset_WH2, sizeof(r_device));
-    memcpy(&cfg->devices[54], &fineoffset_WH0530, sizeof(r_device));
-    memcpy(&cfg->devices[55], &fineoffset_wh1050, sizeof(r_device));
-    memcpy(&cfg->devices[56], &fineoffset_wh1080, sizeof(r_device));
-    memcpy(&cfg->devices[57], &fordremote, sizeof(r_device));
-    memcpy(&cfg->devices[58], &fs20, sizeof(r_device));
-    memcpy(&cfg->devices[59], &ft004b, sizeof(r_device));
-    memcpy(&cfg->devices[60], &funkbus_remote, sizeof(r_device));
-    memcpy(&cfg->devices[61], &gasmate_ba1008, sizeof(r_device));
-    memcpy(&cfg->devices[62], &geevon, sizeof(r_device));
-    memcpy(&cfg->devices[63], &generic_motion, sizeof(r_device));
-    memcpy(&cfg->devices[64], &generic_remote, sizeof(r_device));
-    memcpy(&cfg->devices[65], &generic_temperature_sensor, sizeof(r_device));
-    memcpy(&cfg->devices[66], &govee, sizeof(r_device));
-    memcpy(&cfg->devices[67], &govee_h5054, sizeof(r_device));
-    memcpy(&cfg->devices[68], &gt_tmbbq05, sizeof(r_device));
-    memcpy(&cfg->devices[69], &gt_wt_02, sizeof(r_device));
-    memcpy(&cfg->devices[70], &gt_wt_03, sizeof(r_device));
-    memcpy(&cfg->devices[71], &hcs200, sizeof(r_device));
-    memcpy(&cfg->devices[72], &hideki_ts04, sizeof(r_device));
-    memcpy(&cfg->devices[73], &honeywell, sizeof(r_device));
-    memcpy(&cfg->devices[74], &honeywell_wdb, sizeof(r_device));
-    memcpy(&cfg->devices[75], &ht680, sizeof(r_device));
-    memcpy(&cfg->devices[76], &ibis_beacon, sizeof(r_device));
-    memcpy(&cfg->devices[77], &infactory, sizeof(r_device));
-    memcpy(&cfg->devices[78], &kw9015b, sizeof(r_device));
-    memcpy(&cfg->devices[79], &interlogix, sizeof(r_device));
-    memcpy(&cfg->devices[80], &intertechno, sizeof(r_device));
-    memcpy(&cfg->devices[81], &jasco, sizeof(r_device));
-    memcpy(&cfg->devices[82], &kedsum, sizeof(r_device));
-    memcpy(&cfg->devices[83], &kerui, sizeof(r_device));
-    memcpy(&cfg->devices[84], &klimalogg, sizeof(r_device));
-    memcpy(&cfg->devices[85], &lacrossetx, sizeof(r_device));
-    memcpy(&cfg->devices[86], &lacrosse_tx141x, sizeof(r_device));
-    memcpy(&cfg->devices[87], &lacrosse_ws7000, sizeof(r_device));
-    memcpy(&cfg->devices[88], &lacrossews, sizeof(r_device));
-    memcpy(&cfg->devices[89], &lightwave_rf, sizeof(r_device));
-    memcpy(&cfg->devices[90], &markisol, sizeof(r_device));
-    memcpy(&cfg->devices[91], &maverick_et73, sizeof(r_device));
-    memcpy(&cfg->devices[92], &maverick_et73x, sizeof(r_device));
-    memcpy(&cfg->devices[93], &mebus433, sizeof(r_device));
-    memcpy(&cfg->devices[94], &megacode, sizeof(r_device));
-    memcpy(&cfg->devices[95], &missil_ml0757, sizeof(r_device));
-    memcpy(&cfg->devices[96], &neptune_r900, sizeof(r_device));
-    memcpy(&cfg->devices[97], &new_template, sizeof(r_device));
-    memcpy(&cfg->devices[98], &newkaku, sizeof(r_device));
-    memcpy(&cfg->devices[99], &nexa, sizeof(r_device));
-    memcpy(&cfg->devices[100], &nexus, sizeof(r_device));
-    memcpy(&cfg->devices[101], &nice_flor_s, sizeof(r_device));
-    memcpy(&cfg->devices[102], &norgo, sizeof(r_device));
-    memcpy(&cfg->devices[103], &oil_standard_ask, sizeof(r_device));
-    memcpy(&cfg->devices[104], &opus_xt300, sizeof(r_device));
-    memcpy(&cfg->devices[105], &oregon_scientific, sizeof(r_device));
-    memcpy(&cfg->devices[106], &oregon_scientific_sl109h, sizeof(r_device));
-    memcpy(&cfg->devices[107], &oregon_scientific_v1, sizeof(r_device));
-    memcpy(&cfg->devices[108], &philips_aj3650, sizeof(r_device));
-    memcpy(&cfg->devices[109], &philips_aj7010, sizeof(r_device));
-    memcpy(&cfg->devices[110], &proflame2, sizeof(r_device));
-    memcpy(&cfg->devices[111], &prologue, sizeof(r_device));
-    memcpy(&cfg->devices[112], &proove, sizeof(r_device));
-    memcpy(&cfg->devices[113], &quhwa, sizeof(r_device));
-    memcpy(&cfg->devices[114], &radiohead_ask, sizeof(r_device));
-    memcpy(&cfg->devices[115], &sensible_living, sizeof(r_device));
-    memcpy(&cfg->devices[116], &rainpoint, sizeof(r_device));
-    memcpy(&cfg->devices[117], &regency_fan, sizeof(r_device));
-    memcpy(&cfg->devices[118], &revolt_nc5462, sizeof(r_device));
-    memcpy(&cfg->devices[119], &revolt_zx7717, sizeof(r_device));
-    memcpy(&cfg->devices[120], &rftech, sizeof(r_device));
-    memcpy(&cfg->devices[121], &risco_agility, sizeof(r_device));
-    memcpy(&cfg->devices[122], &rosstech_dcu706, sizeof(r_device));
-    memcpy(&cfg->devices[123], &rubicson, sizeof(r_device));
-    memcpy(&cfg->devices[124], &rubicson_48659, sizeof(r_device));
-    memcpy(&cfg->devices[125], &rubicson_pool_48942, sizeof(r_device));
-    memcpy(&cfg->devices[126], &s3318p, sizeof(r_device));
-    memcpy(&cfg->devices[127], &schou_72543_rain, sizeof(r_device));
-    memcpy(&cfg->devices[128], &schraeder, sizeof(r_device));
-    memcpy(&cfg->devices[129], &schrader_EG53MA4, sizeof(r_device));
-    memcpy(&cfg->devices[130], &schrader_SMD3MA4, sizeof(r_device));
-    memcpy(&cfg->devices[131], &scmplus, sizeof(r_device));
-    memcpy(&cfg->devices[132], &scve_door, sizeof(r_device));
-    memcpy(&cfg->devices[133], &secplus_v1, sizeof(r_device));
-    memcpy(&cfg->devices[134], &silvercrest, sizeof(r_device));
-    memcpy(&cfg->devices[135], &ss_sensor, sizeof(r_device));
-    memcpy(&cfg->devices[136], &skylink_motion, sizeof(r_device));
-    memcpy(&cfg->devices[137], &smoke_gs558, sizeof(r_device));
-    memcpy(&cfg->devices[138], &solight_te44, sizeof(r_device));
-    memcpy(&cfg->devices[139], &somfy_rts, sizeof(r_device));
-    memcpy(&cfg->devices[140], &springfield, sizeof(r_device));
-    memcpy(&cfg->devices[141], &telldus_ft0385r, sizeof(r_device));
-    memcpy(&cfg->devices[142], &tfa_30_3221, sizeof(r_device));
-    memcpy(&cfg->devices[143], &tfa_drop_303233, sizeof(r_device));
-    memcpy(&cfg->devices[144], &tfa_pool_thermometer, sizeof(r_device));
-    memcpy(&cfg->devices[145], &tfa_twin_plus_303049, sizeof(r_device));
-    memcpy(&cfg->devices[146], &thermopro_tp11, sizeof(r_device));
-    memcpy(&cfg->devices[147], &thermopro_tp12, sizeof(r_device));
-    memcpy(&cfg->devices[148], &thermopro_tx2, sizeof(r_device));
-    memcpy(&cfg->devices[149], &thermopro_tx2c, sizeof(r_device));
-    memcpy(&cfg->devices[150], &thermor, sizeof(r_device));
-    memcpy(&cfg->devices[151], &tpms_eezrv, sizeof(r_device));
-    memcpy(&cfg->devices[152], &tpms_gm, sizeof(r_device));
-    memcpy(&cfg->devices[153], &tpms_tyreguard400, sizeof(r_device));
-    memcpy(&cfg->devices[154], &ts_ft002, sizeof(r_device));
-    memcpy(&cfg->devices[155], &ttx201, sizeof(r_device));
-    memcpy(&cfg->devices[156], &vaillant_vrt340f, sizeof(r_device));
-    memcpy(&cfg->devices[157], &vauno_en8822c, sizeof(r_device));
-    memcpy(&cfg->devices[158], &visonic_powercode, sizeof(r_device));
-    memcpy(&cfg->devices[159], &watts_thermostat, sizeof(r_device));
-    memcpy(&cfg->devices[160], &waveman, sizeof(r_device));
-    memcpy(&cfg->devices[161], &wec2103, sizeof(r_device));
-    memcpy(&cfg->devices[162], &wg_pb12v1, sizeof(r_device));
-    memcpy(&cfg->devices[163], &ws2032, sizeof(r_device));
-    memcpy(&cfg->devices[164], &wssensor, sizeof(r_device));
-    memcpy(&cfg->devices[165], &wt1024, sizeof(r_device));
-    memcpy(&cfg->devices[166], &wt450, sizeof(r_device));
-    memcpy(&cfg->devices[167], &X10_RF, sizeof(r_device));
-    memcpy(&cfg->devices[168], &x10_sec, sizeof(r_device));
-    memcpy(&cfg->devices[169], &yale_hsa, sizeof(r_device));
+    cfg->devices[0] = &abmt;
+    cfg->devices[1] = &acurite_rain_896;
+    cfg->devices[2] = &acurite_th;
+    cfg->devices[3] = &acurite_txr;
+    cfg->devices[4] = &acurite_986;
+    cfg->devices[5] = &acurite_606;
+    cfg->devices[6] = &acurite_00275rm;
+    cfg->devices[7] = &acurite_590tx;
+    cfg->devices[8] = &acurite_01185m;
+    cfg->devices[9] = &advent_doorbell;
+    cfg->devices[10] = &akhan_100F14;
+    cfg->devices[11] = &alectov1;
+    cfg->devices[12] = &ambient_weather;
+    cfg->devices[13] = &ambientweather_tx8300;
+    cfg->devices[14] = &atech_ws308;
+    cfg->devices[15] = &auriol_4ld5661;
+    cfg->devices[16] = &auriol_aft77b2;
+    cfg->devices[17] = &auriol_afw2a1;
+    cfg->devices[18] = &auriol_ahfl;
+    cfg->devices[19] = &auriol_hg02832;
+    cfg->devices[20] = &baldr_rain;
+    cfg->devices[21] = &blyss;
+    cfg->devices[22] = &brennenstuhl_rcs_2044;
+    cfg->devices[23] = &bresser_3ch;
+    cfg->devices[24] = &bresser_st1005h;
+    cfg->devices[25] = &bt_rain;
+    cfg->devices[26] = &burnhardbbq;
+    cfg->devices[27] = &calibeur_RF104;
+    cfg->devices[28] = &cardin;
+    cfg->devices[29] = &celsia_czc1;
+    cfg->devices[30] = &chuango;
+    cfg->devices[31] = &cmr113;
+    cfg->devices[32] = &companion_wtr001;
+    cfg->devices[33] = &cotech_36_7959;
+    cfg->devices[34] = &digitech_xc0324;
+    cfg->devices[35] = &dish_remote_6_3;
+    cfg->devices[36] = &dooya_curtain;
+    cfg->devices[37] = &dsc_security;
+    cfg->devices[38] = &dsc_security_ws4945;
+    cfg->devices[39] = &ecowitt;
+    cfg->devices[40] = &eurochron_efth800;
+    cfg->devices[41] = &elro_db286a;
+    cfg->devices[42] = &elv_em1000;
+    cfg->devices[43] = &elv_ws2000;
+    cfg->devices[44] = &emos_e6016;
+    cfg->devices[45] = &emos_e6016_rain;
+    cfg->devices[46] = &enocean_erp1;
+    cfg->devices[47] = &ert_idm;
+    cfg->devices[48] = &ert_netidm;
+    cfg->devices[49] = &ert_scm;
+    cfg->devices[50] = &esa_energy;
+    cfg->devices[51] = &esperanza_ews;
+    cfg->devices[52] = &eurochron;
+    cfg->devices[53] = &fineoffset_WH2;
+    cfg->devices[54] = &fineoffset_WH0530;
+    cfg->devices[55] = &fineoffset_wh1050;
+    cfg->devices[56] = &fineoffset_wh1080;
+    cfg->devices[57] = &fordremote;
+    cfg->devices[58] = &fs20;
+    cfg->devices[59] = &ft004b;
+    cfg->devices[60] = &funkbus_remote;
+    cfg->devices[61] = &gasmate_ba1008;
+    cfg->devices[62] = &geevon;
+    cfg->devices[63] = &generic_motion;
+    cfg->devices[64] = &generic_remote;
+    cfg->devices[65] = &generic_temperature_sensor;
+    cfg->devices[66] = &govee;
+    cfg->devices[67] = &govee_h5054;
+    cfg->devices[68] = &gt_tmbbq05;
+    cfg->devices[69] = &gt_wt_02;
+    cfg->devices[70] = &gt_wt_03;
+    cfg->devices[71] = &hcs200;
+    cfg->devices[72] = &hideki_ts04;
+    cfg->devices[73] = &honeywell;
+    cfg->devices[74] = &honeywell_wdb;
+    cfg->devices[75] = &ht680;
+    cfg->devices[76] = &ibis_beacon;
+    cfg->devices[77] = &infactory;
+    cfg->devices[78] = &kw9015b;
+    cfg->devices[79] = &interlogix;
+    cfg->devices[80] = &intertechno;
+    cfg->devices[81] = &jasco;
+    cfg->devices[82] = &kedsum;
+    cfg->devices[83] = &kerui;
+    cfg->devices[84] = &klimalogg;
+    cfg->devices[85] = &lacrossetx;
+    cfg->devices[86] = &lacrosse_tx141x;
+    cfg->devices[87] = &lacrosse_ws7000;
+    cfg->devices[88] = &lacrossews;
+    cfg->devices[89] = &lightwave_rf;
+    cfg->devices[90] = &markisol;
+    cfg->devices[91] = &maverick_et73;
+    cfg->devices[92] = &maverick_et73x;
+    cfg->devices[93] = &mebus433;
+    cfg->devices[94] = &megacode;
+    cfg->devices[95] = &missil_ml0757;
+    cfg->devices[96] = &neptune_r900;
+    cfg->devices[97] = &new_template;
+    cfg->devices[98] = &newkaku;
+    cfg->devices[99] = &nexa;
+    cfg->devices[100] = &nexus;
+    cfg->devices[101] = &nice_flor_s;
+    cfg->devices[102] = &norgo;
+    cfg->devices[103] = &oil_standard_ask;
+    cfg->devices[104] = &opus_xt300;
+    cfg->devices[105] = &oregon_scientific;
+    cfg->devices[106] = &oregon_scientific_sl109h;
+    cfg->devices[107] = &oregon_scientific_v1;
+    cfg->devices[108] = &philips_aj3650;
+    cfg->devices[109] = &philips_aj7010;
+    cfg->devices[110] = &proflame2;
+    cfg->devices[111] = &prologue;
+    cfg->devices[112] = &proove;
+    cfg->devices[113] = &quhwa;
+    cfg->devices[114] = &radiohead_ask;
+    cfg->devices[115] = &sensible_living;
+    cfg->devices[116] = &rainpoint;
+    cfg->devices[117] = &regency_fan;
+    cfg->devices[118] = &revolt_nc5462;
+    cfg->devices[119] = &revolt_zx7717;
+    cfg->devices[120] = &rftech;
+    cfg->devices[121] = &risco_agility;
+    cfg->devices[122] = &rosstech_dcu706;
+    cfg->devices[123] = &rubicson;
+    cfg->devices[124] = &rubicson_48659;
+    cfg->devices[125] = &rubicson_pool_48942;
+    cfg->devices[126] = &s3318p;
+    cfg->devices[127] = &schou_72543_rain;
+    cfg->devices[128] = &schraeder;
+    cfg->devices[129] = &schrader_EG53MA4;
+    cfg->devices[130] = &schrader_SMD3MA4;
+    cfg->devices[131] = &scmplus;
+    cfg->devices[132] = &scve_door;
+    cfg->devices[133] = &secplus_v1;
+    cfg->devices[134] = &silvercrest;
+    cfg->devices[135] = &ss_sensor;
+    cfg->devices[136] = &skylink_motion;
+    cfg->devices[137] = &smoke_gs558;
+    cfg->devices[138] = &solight_te44;
+    cfg->devices[139] = &somfy_rts;
+    cfg->devices[140] = &springfield;
+    cfg->devices[141] = &telldus_ft0385r;
+    cfg->devices[142] = &tfa_30_3221;
+    cfg->devices[143] = &tfa_drop_303233;
+    cfg->devices[144] = &tfa_pool_thermometer;
+    cfg->devices[145] = &tfa_twin_plus_303049;
+    cfg->devices[146] = &thermopro_tp11;
+    cfg->devices[147] = &thermopro_tp12;
+    cfg->devices[148] = &thermopro_tx2;
+    cfg->devices[149] = &thermopro_tx2c;
+    cfg->devices[150] = &thermor;
+    cfg->devices[151] = &tpms_eezrv;
+    cfg->devices[152] = &tpms_gm;
+    cfg->devices[153] = &tpms_tyreguard400;
+    cfg->devices[154] = &ts_ft002;
+    cfg->devices[155] = &ttx201;
+    cfg->devices[156] = &vaillant_vrt340f;
+    cfg->devices[157] = &vauno_en8822c;
+    cfg->devices[158] = &visonic_powercode;
+    cfg->devices[159] = &watts_thermostat;
+    cfg->devices[160] = &waveman;
+    cfg->devices[161] = &wec2103;
+    cfg->devices[162] = &wg_pb12v1;
+    cfg->devices[163] = &ws2032;
+    cfg->devices[164] = &wssensor;
+    cfg->devices[165] = &wt1024;
+    cfg->devices[166] = &wt450;
+    cfg->devices[167] = &X10_RF;
+    cfg->devices[168] = &x10_sec;
+    cfg->devices[169] = &yale_hsa;
   } else {
-    memcpy(&cfg->devices[0], &ambientweather_wh31e, sizeof(r_device));
-    memcpy(&cfg->devices[1], &ant_antplus, sizeof(r_device));
-    memcpy(&cfg->devices[2], &arad_ms_meter, sizeof(r_device));
-    memcpy(&cfg->devices[3], &archos_tbh, sizeof(r_device));
-    memcpy(&cfg->devices[4], &arexx_ml, sizeof(r_device));
-    memcpy(&cfg->devices[5], &badger_orion, sizeof(r_device));
-    memcpy(&cfg->devices[6], &bresser_5in1, sizeof(r_device));
-    memcpy(&cfg->devices[7], &bresser_6in1, sizeof(r_device));
-    memcpy(&cfg->devices[8], &bresser_7in1, sizeof(r_device));
-    memcpy(&cfg->devices[9], &bresser_leakage, sizeof(r_device));
-    memcpy(&cfg->devices[10], &bresser_lightning, sizeof(r_device));
-    memcpy(&cfg->devices[11], &cavius, sizeof(r_device));
-    memcpy(&cfg->devices[12], &ced7000, sizeof(r_device));
-    memcpy(&cfg->devices[13], &chamberlain_cwpirc, sizeof(r_device));
-    memcpy(&cfg->devices[14], &current_cost, sizeof(r_device));
-    memcpy(&cfg->devices[15], &danfoss_CFR, sizeof(r_device));
-    memcpy(&cfg->devices[16], &deltadore_x3d, sizeof(r_device));
-    memcpy(&cfg->devices[17], &directv, sizeof(r_device));
-    memcpy(&cfg->devices[18], &ecodhome, sizeof(r_device));
-    memcpy(&cfg->devices[19], &efergy_e2_classic, sizeof(r_device));
-    memcpy(&cfg->devices[20], &efergy_optical, sizeof(r_device));
-    memcpy(&cfg->devices[21], &emax, sizeof(r_device));
-    memcpy(&cfg->devices[22], &emontx, sizeof(r_device));
-    memcpy(&cfg->devices[23], &esic_emt7110, sizeof(r_device));
-    memcpy(&cfg->devices[24], &fineoffset_WH25, sizeof(r_device));
-    memcpy(&cfg->devices[25], &fineoffset_WH51, sizeof(r_device));
-    memcpy(&cfg->devices[26], &tfa_303151, sizeof(r_device));
-    memcpy(&cfg->devices[27], &fineoffset_wh1080_fsk, sizeof(r_device));
-    memcpy(&cfg->devices[28], &fineoffset_wh31l, sizeof(r_device));
-    memcpy(&cfg->devices[29], &fineoffset_wh45, sizeof(r_device));
-    memcpy(&cfg->devices[30], &fineoffset_wh46, sizeof(r_device));
-    memcpy(&cfg->devices[31], &fineoffset_wh55, sizeof(r_device));
-    memcpy(&cfg->devices[32], &fineoffset_wn34, sizeof(r_device));
-    memcpy(&cfg->devices[33], &fineoffset_ws80, sizeof(r_device));
-    memcpy(&cfg->devices[34], &fineoffset_ws90, sizeof(r_device));
-    memcpy(&cfg->devices[35], &flowis, sizeof(r_device));
-    memcpy(&cfg->devices[36], &ge_coloreffects, sizeof(r_device));
-    memcpy(&cfg->devices[37], &geo_minim, sizeof(r_device));
-    memcpy(&cfg->devices[38], &gridstream96, sizeof(r_device));
-    memcpy(&cfg->devices[39], &gridstream192, sizeof(r_device));
-    memcpy(&cfg->devices[40], &gridstream384, sizeof(r_device));
-    memcpy(&cfg->devices[41], &hcs200_fsk, sizeof(r_device));
-    memcpy(&cfg->devices[42], &holman_ws5029pcm, sizeof(r_device));
-    memcpy(&cfg->devices[43], &holman_ws5029pwm, sizeof(r_device));
-    memcpy(&cfg->devices[44], &hondaremote, sizeof(r_device));
-    memcpy(&cfg->devices[45], &honeywell_cm921, sizeof(r_device));
-    memcpy(&cfg->devices[46], &honeywell_wdb_fsk, sizeof(r_device));
-    memcpy(&cfg->devices[47], &ikea_sparsnas, sizeof(r_device));
-    memcpy(&cfg->devices[48], &inkbird_ith20r, sizeof(r_device));
-    memcpy(&cfg->devices[49], &insteon, sizeof(r_device));
-    memcpy(&cfg->devices[50], &lacrosse_breezepro, sizeof(r_device));
-    memcpy(&cfg->devices[51], &lacrosse_r1, sizeof(r_device));
-    memcpy(&cfg->devices[52], &lacrosse_th3, sizeof(r_device));
-    memcpy(&cfg->devices[53], &lacrosse_tx31u, sizeof(r_device));
-    memcpy(&cfg->devices[54], &lacrosse_tx34, sizeof(r_device));
-    memcpy(&cfg->devices[55], &lacrosse_tx29, sizeof(r_device));
-    memcpy(&cfg->devices[56], &lacrosse_tx35, sizeof(r_device));
-    memcpy(&cfg->devices[57], &lacrosse_wr1, sizeof(r_device));
-    memcpy(&cfg->devices[58], &m_bus_mode_c_t, sizeof(r_device));
-    memcpy(&cfg->devices[59], &m_bus_mode_c_t_downlink, sizeof(r_device));
-    memcpy(&cfg->devices[60], &m_bus_mode_s, sizeof(r_device));
-    memcpy(&cfg->devices[61], &m_bus_mode_r, sizeof(r_device));
-    memcpy(&cfg->devices[62], &m_bus_mode_f, sizeof(r_device));
-    memcpy(&cfg->devices[63], &marlec_solar, sizeof(r_device));
-    memcpy(&cfg->devices[64], &maverick_xr30, sizeof(r_device));
-    memcpy(&cfg->devices[65], &mueller_hotrod, sizeof(r_device));
-    memcpy(&cfg->devices[66], &oil_smart, sizeof(r_device));
-    memcpy(&cfg->devices[67], &oil_standard, sizeof(r_device));
-    memcpy(&cfg->devices[68], &oil_watchman, sizeof(r_device));
-    memcpy(&cfg->devices[69], &oil_watchman_advanced, sizeof(r_device));
-    memcpy(&cfg->devices[70], &quinetic, sizeof(r_device));
-    memcpy(&cfg->devices[71], &rojaflex, sizeof(r_device));
-    memcpy(&cfg->devices[72], &sharp_spc775, sizeof(r_device));
-    memcpy(&cfg->devices[73], &simplisafe_gen3, sizeof(r_device));
-    memcpy(&cfg->devices[74], &somfy_iohc, sizeof(r_device));
-    memcpy(&cfg->devices[75], &srsmith_pool_srs_2c_tx, sizeof(r_device));
-    memcpy(&cfg->devices[76], &steelmate, sizeof(r_device));
-    memcpy(&cfg->devices[77], &tfa_14_1504_v2, sizeof(r_device));
-    memcpy(&cfg->devices[78], &tfa_303196, sizeof(r_device));
-    memcpy(&cfg->devices[79], &tfa_marbella, sizeof(r_device));
-    memcpy(&cfg->devices[80], &thermopro_tp28b, sizeof(r_device));
-    memcpy(&cfg->devices[81], &thermopro_tp828b, sizeof(r_device));
-    memcpy(&cfg->devices[82], &thermopro_tp829b, sizeof(r_device));
-    memcpy(&cfg->devices[83], &tpms_abarth124, sizeof(r_device));
-    memcpy(&cfg->devices[84], &tpms_ave, sizeof(r_device));
-    memcpy(&cfg->devices[85], &tpms_bmw, sizeof(r_device));
-    memcpy(&cfg->devices[86], &tpms_bmwg3, sizeof(r_device));
-    memcpy(&cfg->devices[87], &tpms_citroen, sizeof(r_device));
-    memcpy(&cfg->devices[88], &tpms_elantra2012, sizeof(r_device));
-    memcpy(&cfg->devices[89], &tpms_ford, sizeof(r_device));
-    memcpy(&cfg->devices[90], &tpms_hyundai_vdo, sizeof(r_device));
-    memcpy(&cfg->devices[91], &tpms_jansite, sizeof(r_device));
-    memcpy(&cfg->devices[92], &tpms_jansite_solar, sizeof(r_device));
-    memcpy(&cfg->devices[93], &tpms_kia, sizeof(r_device));
-    memcpy(&cfg->devices[94], &tpms_nissan, sizeof(r_device));
-    memcpy(&cfg->devices[95], &tpms_pmv107j, sizeof(r_device));
-    memcpy(&cfg->devices[96], &tpms_porsche, sizeof(r_device));
-    memcpy(&cfg->devices[97], &tpms_renault, sizeof(r_device));
-    memcpy(&cfg->devices[98], &tpms_renault_0435r, sizeof(r_device));
-    memcpy(&cfg->devices[99], &tpms_toyota, sizeof(r_device));
-    memcpy(&cfg->devices[100], &tpms_truck, sizeof(r_device));
-    memcpy(&cfg->devices[101], &vevor_7in1, sizeof(r_device));
+    cfg->devices[0] = &ambientweather_wh31e;
+    cfg->devices[1] = &ant_antplus;
+    cfg->devices[2] = &arad_ms_meter;
+    cfg->devices[3] = &archos_tbh;
+    cfg->devices[4] = &arexx_ml;
+    cfg->devices[5] = &badger_orion;
+    cfg->devices[6] = &bresser_5in1;
+    cfg->devices[7] = &bresser_6in1;
+    cfg->devices[8] = &bresser_7in1;
+    cfg->devices[9] = &bresser_leakage;
+    cfg->devices[10] = &bresser_lightning;
+    cfg->devices[11] = &cavius;
+    cfg->devices[12] = &ced7000;
+    cfg->devices[13] = &chamberlain_cwpirc;
+    cfg->devices[14] = &current_cost;
+    cfg->devices[15] = &danfoss_CFR;
+    cfg->devices[16] = &deltadore_x3d;
+    cfg->devices[17] = &directv;
+    cfg->devices[18] = &ecodhome;
+    cfg->devices[19] = &efergy_e2_classic;
+    cfg->devices[20] = &efergy_optical;
+    cfg->devices[21] = &emax;
+    cfg->devices[22] = &emontx;
+    cfg->devices[23] = &esic_emt7110;
+    cfg->devices[24] = &fineoffset_WH25;
+    cfg->devices[25] = &fineoffset_WH51;
+    cfg->devices[26] = &tfa_303151;
+    cfg->devices[27] = &fineoffset_wh1080_fsk;
+    cfg->devices[28] = &fineoffset_wh31l;
+    cfg->devices[29] = &fineoffset_wh45;
+    cfg->devices[30] = &fineoffset_wh46;
+    cfg->devices[31] = &fineoffset_wh55;
+    cfg->devices[32] = &fineoffset_wn34;
+    cfg->devices[33] = &fineoffset_ws80;
+    cfg->devices[34] = &fineoffset_ws90;
+    cfg->devices[35] = &flowis;
+    cfg->devices[36] = &ge_coloreffects;
+    cfg->devices[37] = &geo_minim;
+    cfg->devices[38] = &gridstream96;
+    cfg->devices[39] = &gridstream192;
+    cfg->devices[40] = &gridstream384;
+    cfg->devices[41] = &hcs200_fsk;
+    cfg->devices[42] = &holman_ws5029pcm;
+    cfg->devices[43] = &holman_ws5029pwm;
+    cfg->devices[44] = &hondaremote;
+    cfg->devices[45] = &honeywell_cm921;
+    cfg->devices[46] = &honeywell_wdb_fsk;
+    cfg->devices[47] = &ikea_sparsnas;
+    cfg->devices[48] = &inkbird_ith20r;
+    cfg->devices[49] = &insteon;
+    cfg->devices[50] = &lacrosse_breezepro;
+    cfg->devices[51] = &lacrosse_r1;
+    cfg->devices[52] = &lacrosse_th3;
+    cfg->devices[53] = &lacrosse_tx31u;
+    cfg->devices[54] = &lacrosse_tx34;
+    cfg->devices[55] = &lacrosse_tx29;
+    cfg->devices[56] = &lacrosse_tx35;
+    cfg->devices[57] = &lacrosse_wr1;
+    cfg->devices[58] = &m_bus_mode_c_t;
+    cfg->devices[59] = &m_bus_mode_c_t_downlink;
+    cfg->devices[60] = &m_bus_mode_s;
+    cfg->devices[61] = &m_bus_mode_r;
+    cfg->devices[62] = &m_bus_mode_f;
+    cfg->devices[63] = &marlec_solar;
+    cfg->devices[64] = &maverick_xr30;
+    cfg->devices[65] = &mueller_hotrod;
+    cfg->devices[66] = &oil_smart;
+    cfg->devices[67] = &oil_standard;
+    cfg->devices[68] = &oil_watchman;
+    cfg->devices[69] = &oil_watchman_advanced;
+    cfg->devices[70] = &quinetic;
+    cfg->devices[71] = &rojaflex;
+    cfg->devices[72] = &sharp_spc775;
+    cfg->devices[73] = &simplisafe_gen3;
+    cfg->devices[74] = &somfy_iohc;
+    cfg->devices[75] = &srsmith_pool_srs_2c_tx;
+    cfg->devices[76] = &steelmate;
+    cfg->devices[77] = &tfa_14_1504_v2;
+    cfg->devices[78] = &tfa_303196;
+    cfg->devices[79] = &tfa_marbella;
+    cfg->devices[80] = &thermopro_tp28b;
+    cfg->devices[81] = &thermopro_tp828b;
+    cfg->devices[82] = &thermopro_tp829b;
+    cfg->devices[83] = &tpms_abarth124;
+    cfg->devices[84] = &tpms_ave;
+    cfg->devices[85] = &tpms_bmw;
+    cfg->devices[86] = &tpms_bmwg3;
+    cfg->devices[87] = &tpms_citroen;
+    cfg->devices[88] = &tpms_elantra2012;
+    cfg->devices[89] = &tpms_ford;
+    cfg->devices[90] = &tpms_hyundai_vdo;
+    cfg->devices[91] = &tpms_jansite;
+    cfg->devices[92] = &tpms_jansite_solar;
+    cfg->devices[93] = &tpms_kia;
+    cfg->devices[94] = &tpms_nissan;
+    cfg->devices[95] = &tpms_pmv107j;
+    cfg->devices[96] = &tpms_porsche;
+    cfg->devices[97] = &tpms_renault;
+    cfg->devices[98] = &tpms_renault_0435r;
+    cfg->devices[99] = &tpms_toyota;
+    cfg->devices[100] = &tpms_truck;
+    cfg->devices[101] = &vevor_7in1;
   }
   
     // end of fragment
 
 #else
-    memcpy(&cfg->devices[0], &lacrosse_tx141x, sizeof(r_device));
+    cfg->devices[0] = &lacrosse_tx141x;
 #endif
 
 #ifdef RTL_FLEX
@@ -376,8 +586,7 @@ void rtlSetup() {
 
     r_device* flex_device;
     flex_device = flex_create_device(RTL_FLEX);
-    memcpy(&cfg->devices[101], &flex_device, sizeof(r_device));
-    register_protocol(cfg, flex_device, NULL);
+    register_protocol(cfg, flex_device, NULL); // numbered after the list
     alogprintfLn(LOG_INFO, "Flex Decoder enabled: %s", RTL_FLEX);
 #endif
 
@@ -392,9 +601,9 @@ void rtlSetup() {
 
 #ifdef DEMOD_DEBUG
     logprintfLn(LOG_INFO, "# of device(s) configured %d", cfg->num_r_devices);
-    logprintfLn(LOG_INFO, "ssizeof(r_device): %d", sizeof(r_device));
+    logprintfLn(LOG_INFO, "sizeof(r_device_state): %d", sizeof(r_device_state));
     logprintfLn(LOG_INFO, "cfg->devices size: %d",
-                sizeof(r_device) * cfg->num_r_devices);
+                sizeof(*cfg->devices) * cfg->num_r_devices);
 #endif
 #ifdef RTL_DEBUG
     cfg->verbosity = RTL_DEBUG + 5; // 0=normal, 1=verbose, 2=verbose decoders,
@@ -414,41 +623,50 @@ void rtlSetup() {
 
     for (int i = 0; i < cfg->num_r_devices; i++) {
       // register all device protocols that are not disabled
-      cfg->devices[i].protocol_num = i;
 #ifdef MEMORY_DEBUG
       logprintfLn(LOG_DEBUG, "Pre register_protocol %d %s, heap %d", i,
-                  cfg->devices[i].name, ESP.getFreeHeap());
+                  cfg->devices[i]->name, ESP.getFreeHeap());
 #endif
 #ifdef RESOURCE_DEBUG
       int preStack = uxTaskGetStackHighWaterMark(NULL);
       int preHeap = ESP.getFreeHeap();
 #endif
 
-      char* arg = NULL;
-      char verbose[4] = "vvv";
-#ifndef RTL_VERBOSE
-#  define RTL_VERBOSE -1
-#endif
-      if (RTL_VERBOSE && i == RTL_VERBOSE) {
-        arg = verbose;
-      }
-      if (cfg->devices[i].disabled <= 0) {
-        register_protocol(cfg, &cfg->devices[i], arg);
+      char arg[DECODER_ARG_SIZE];
+      if (cfg->devices[i]->disabled <= 0) {
+        register_protocol(cfg, cfg->devices[i], decoderArg(i, arg));
       }
 #ifdef RESOURCE_DEBUG
       int deltaStack = preStack - uxTaskGetStackHighWaterMark(NULL);
       int deltaHeap = preHeap - ESP.getFreeHeap();
       if (deltaStack || (deltaHeap > 200)) {
-        logprintfLn(LOG_DEBUG, "Process rtl_433_DecoderTask resource hit %s, deltaStack: %d, stack: %u, deltaHeap: %d, heap: %d", cfg->devices[i].name,
+        logprintfLn(LOG_DEBUG, "Process rtl_433_DecoderTask resource hit %s, deltaStack: %d, stack: %u, deltaHeap: %d, heap: %d", cfg->devices[i]->name,
                     deltaStack, uxTaskGetStackHighWaterMark(NULL), deltaHeap, ESP.getFreeHeap());
       }
 #endif
     }
 
+    updateResetLimit(cfg);
+    rtl_433_EnabledDecoders = cfg->demod->r_devs.len;
+
 #ifdef MEMORY_DEBUG
     logprintfLn(LOG_DEBUG, "Pre xQueueCreate heap %d", ESP.getFreeHeap());
 #endif
-    rtl_433_Queue = xQueueCreate(5, sizeof(pulse_data_t*));
+    rtl_433_PulseTrains = (pulse_data_t*)heap_caps_calloc(
+        RECEIVER_BUFFER_SIZE, sizeof(pulse_data_t), MALLOC_CAP_INTERNAL);
+    if (!rtl_433_PulseTrains)
+      FATAL_CALLOC("rtl_433_PulseTrains");
+    rtl_433_FreeQueue = xQueueCreate(RECEIVER_BUFFER_SIZE, sizeof(pulse_data_t*));
+    for (int i = 0; i < RECEIVER_BUFFER_SIZE; i++) {
+      pulse_data_t* rtl_pulses = &rtl_433_PulseTrains[i];
+      xQueueSend(rtl_433_FreeQueue, &rtl_pulses, 0);
+    }
+    // Queue can hold every train in the pool, so a send never fails
+    rtl_433_Queue = xQueueCreate(RECEIVER_BUFFER_SIZE, sizeof(pulse_data_t*));
+    rtl_433_ChangeQueue = xQueueCreate(DECODER_CHANGES, sizeof(decoder_change_t));
+    rtl_433_DecoderSet = xQueueCreateSet(RECEIVER_BUFFER_SIZE + DECODER_CHANGES);
+    xQueueAddToSet(rtl_433_Queue, rtl_433_DecoderSet);
+    xQueueAddToSet(rtl_433_ChangeQueue, rtl_433_DecoderSet);
 
 #ifdef MEMORY_DEBUG
     logprintfLn(LOG_DEBUG, "Pre xTaskCreatePinnedToCore heap %d",
@@ -490,7 +708,16 @@ void rtl_433_DecoderTask(void* pvParameters) {
   pulse_data_t* rtl_pulses = nullptr;
   for (;;) {
     // logprintfLn(LOG_DEBUG, "rtl_433_DecoderTask awaiting signal");
-    xQueueReceive(rtl_433_Queue, &rtl_pulses, portMAX_DELAY);
+    if (xQueueSelectFromSet(rtl_433_DecoderSet, portMAX_DELAY) ==
+        rtl_433_ChangeQueue) {
+      // applied at once, also on a quiet channel, later wake ups for changes
+      // already drained find the queue empty
+      applyDecoderChanges(&g_cfg);
+      continue;
+    }
+    if (xQueueReceive(rtl_433_Queue, &rtl_pulses, 0) != pdTRUE) {
+      continue;
+    }
     // logprintfLn(LOG_DEBUG, "rtl_433_DecoderTask signal received");
 #ifdef MEMORY_DEBUG
     unsigned long signalProcessingStart = micros();
@@ -499,8 +726,8 @@ void rtl_433_DecoderTask(void* pvParameters) {
 #ifdef RAW_SIGNAL_DEBUG
     logprintf(LOG_INFO, "RAW (%lu): ", rtl_pulses->signalDuration);
     for (int i = 0; i < rtl_pulses->num_pulses; i++) {
-      alogprintf(LOG_INFO, "+%d", rtl_pulses->pulse[i]);
-      alogprintf(LOG_INFO, "-%d", rtl_pulses->gap[i]);
+      alogprintf(LOG_INFO, "+%d", pulse_data_get_pulse(rtl_pulses, i));
+      alogprintf(LOG_INFO, "-%d", pulse_data_get_gap(rtl_pulses, i));
 #  ifdef SIGNAL_RSSI
       alogprintf(LOG_INFO, "(%d)", rtl_pulses->rssi[i]);
 #  endif
@@ -512,14 +739,34 @@ void rtl_433_DecoderTask(void* pvParameters) {
 #endif
     rtl_pulses->sample_rate = 1.0e6;
     r_cfg_t* cfg = &g_cfg;
-    cfg->demod->pulse_data = *rtl_pulses;
+    cfg->demod->pulse_data = rtl_pulses;
     int events = 0;
 
+#if REPEAT_WINDOW > 0
+    // Sensors send several identical repeats, decode only the first one
+    uint32_t fingerprint = trainFingerprint(rtl_pulses);
+    if (decodedRecently(fingerprint)) {
+      rtl_433_ESP::repeatSignals++;
+#  ifdef DEMOD_DEBUG
+      logprintfLn(LOG_INFO, "Repeat signal skipped, pulses: %d",
+                  rtl_pulses->num_pulses);
+#  endif
+      cfg->demod->pulse_data = NULL;
+      releasePulseTrain(rtl_pulses);
+      continue;
+    }
+#endif
+
     if (rtl_433_ESP::ookModulation) {
-      events = run_ook_demods(&cfg->demod->r_devs, rtl_pulses);
+      events = run_ook_demods(cfg->demod, rtl_pulses);
     } else {
-      events = run_fsk_demods(&cfg->demod->r_devs, rtl_pulses);
+      events = run_fsk_demods(cfg->demod, rtl_pulses);
+    }
+#if REPEAT_WINDOW > 0
+    if (events > 0) {
+      rememberDecoded(fingerprint);
     }
+#endif
     if (events == 0) {
 #ifdef RTL_ANALYZER
       pulse_analyzer(rtl_pulses, rtl_433_ESP::ookModulation ? 1 : 2);
@@ -536,8 +783,8 @@ void rtl_433_DecoderTask(void* pvParameters) {
       logprintf(LOG_INFO, "RAW (%lu): ", rtl_pulses->signalDuration);
 #  ifndef RAW_SIGNAL_DEBUG
       for (int i = 0; i < rtl_pulses->num_pulses; i++) {
-        alogprintf(LOG_INFO, "+%d", rtl_pulses->pulse[i]);
-        alogprintf(LOG_INFO, "-%d", rtl_pulses->gap[i]);
+        alogprintf(LOG_INFO, "+%d", pulse_data_get_pulse(rtl_pulses, i));
+        alogprintf(LOG_INFO, "-%d", pulse_data_get_gap(rtl_pulses, i));
 #    ifdef SIGNAL_RSSI
         alogprintf(LOG_INFO, "(%d)", rtl_pulses->rssi[i]);
 #    endif
@@ -589,14 +836,9 @@ void rtl_433_DecoderTask(void* pvParameters) {
       alogprintfLn(LOG_INFO, " ");
     }
 #endif
+    cfg->demod->pulse_data = NULL;
+    releasePulseTrain(rtl_pulses);
 #ifdef MEMORY_DEBUG
-    logprintfLn(LOG_INFO, "Pre free rtl_433_DecoderTask: %d",
-                ESP.getFreeHeap());
-#endif
-    free(rtl_pulses);
-#ifdef MEMORY_DEBUG
-    logprintfLn(LOG_INFO, "Post free rtl_433_DecoderTask: %d",
-                ESP.getFreeHeap());
     logprintfLn(LOG_INFO, "rtl_433_DecoderTask uxTaskGetStackHighWaterMark: %d",
                 uxTaskGetStackHighWaterMark(NULL));
 #endif
@@ -608,8 +850,108 @@ void processSignal(pulse_data_t* rtl_pulses) {
   // rtl_433_Queue");
   if (xQueueSend(rtl_433_Queue, &rtl_pulses, 0) != pdTRUE) {
     logprintfLn(LOG_ERR, "ERROR: rtl_433_Queue full, discarding signal");
-    free(rtl_pulses);
+    releasePulseTrain(rtl_pulses);
   } else {
     // logprintfLn(LOG_DEBUG, "processSignal() signal placed on rtl_433_Queue");
   }
 }
+
+/**
+ * @brief Take an empty pulse train from the pool for signal capture
+ *
+ * @return pulse_data_t* - pulse train, or NULL if all are in use
+ */
+pulse_data_t* acquirePulseTrain() {
+  pulse_data_t* rtl_pulses = NULL;
+  if (xQueueReceive(rtl_433_FreeQueue, &rtl_pulses, 0) != pdTRUE) {
+    return NULL;
+  }
+  return rtl_pulses;
+}
+
+/**
+ * @brief Return a pulse train to the pool. Only the first num_pulses entries
+ * have been written during capture, so only those are cleared.
+ *
+ * @param rtl_pulses
+ */
+void releasePulseTrain(pulse_data_t* rtl_pulses) {
+  unsigned int used = rtl_pulses->num_pulses;
+  if (used > PD_MAX_PULSES) {
+    used = PD_MAX_PULSES;
+  }
+  memset(rtl_pulses->pulse, 0, used * sizeof(rtl_pulses->pulse[0]));
+  memset(rtl_pulses->gap, 0, used * sizeof(rtl_pulses->gap[0]));
+#ifdef SIGNAL_RSSI
+  memset(rtl_pulses->rssi, 0, used * sizeof(rtl_pulses->rssi[0]));
+#endif
+  rtl_pulses->num_pulses = 0;
+  rtl_pulses->num_long = 0;
+  xQueueSend(rtl_433_FreeQueue, &rtl_pulses, 0);
+}
+
+/**
+ * @brief Number of pulse trains available for capture
+ */
+int freePulseTrains() {
+  return rtl_433_FreeQueue ? uxQueueMessagesWaiting(rtl_433_FreeQueue) : 0;
+}
+
+/**
+ * @brief Gap in micros after the last edge that ends a packet
+ */
+unsigned long packetResetLimit() {
+  return rtl_433_ResetLimit;
+}
+
+/**
+ * @brief Number of duplicate messages dropped within MESSAGE_DEDUP_WINDOW
+ */
+unsigned int duplicateMessages() {
+  return g_cfg.dedup_suppressed;
+}
+
+/**
+ * @brief Protocol number of a decoder in the device list
+ *
+ * @param name - decoder name, as in the decoder table of the README
+ * @return int - protocol number, -1 if unknown
+ */
+int decoderProtocol(const char* name) {
+  r_cfg_t* cfg = &g_cfg;
+  for (int i = 0; cfg->devices && name && i < cfg->num_r_devices; i++) {
+    if (!strcmp(cfg->devices[i]->name, name)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Queue a decoder to be enabled or disabled by the decoder task, after
+ * the pulse train being decoded
+ *
+ * @param protocol - protocol number, -1 for all decoders
+ * @param enable
+ * @return true if the change is queued
+ */
+bool changeDecoder(int protocol, bool enable) {
+  r_cfg_t* cfg = &g_cfg;
+  if (!rtl_433_ChangeQueue || protocol < -1 || protocol >= cfg->num_r_devices) {
+    logprintfLn(LOG_ERR, "ERROR: Unknown decoder %d", protocol);
+    return false;
+  }
+  decoder_change_t change = {protocol, enable};
+  if (xQueueSend(rtl_433_ChangeQueue, &change, 0) != pdTRUE) {
+    logprintfLn(LOG_ERR, "ERROR: rtl_433_ChangeQueue full, discarding change");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Number of decoders run on each pulse train
+ */
+int enabledDecoders() {
+  return rtl_433_EnabledDecoders;
+}
@@ -50,6 +50,14 @@ void _setCallback(rtl_433_ESPCallBack callback, char* messageBuffer,
                   int bufferSize);
 void _setDebug(int debug);
 void processSignal(pulse_data_t* rtl_pulses);
+pulse_data_t* acquirePulseTrain();
+void releasePulseTrain(pulse_data_t* rtl_pulses);
+int freePulseTrains();
+unsigned long packetResetLimit();
+unsigned int duplicateMessages();
+int decoderProtocol(const char* name);
+bool changeDecoder(int protocol, bool enable);
+int enabledDecoders();
 void rtl_433_DecoderTask(void* pvParameters);
 extern TaskHandle_t rtl_433_DecoderHandle;
 
@@ -80,12 +80,12 @@ echo "" >> decoder.fragment
 echo "if (rtl_433_ESP::ookModulation) {" >> decoder.fragment
 
 cat devices.list | awk -f device.awk | egrep ${OOK_MODULATION} | awk -F\" '{ print $3 }' | \
-    awk -F, '{ print $3 }' | awk '{ print "  memcpy(&cfg->devices["NR-1"], &"$1", sizeof(r_device));" }' >> decoder.fragment
+    awk -F, '{ print $3 }' | awk '{ print "  cfg->devices["NR-1"] = &"$1";" }' >> decoder.fragment
 
 echo "} else {" >> decoder.fragment
 
 cat devices.list | awk -f device.awk | egrep ${FSK_MODULATION} | awk -F\" '{ print $3 }' | \
-    awk -F, '{ print $3 }' | awk '{ print "  memcpy(&cfg->devices["NR-1"], &"$1", sizeof(r_device));" }' >> decoder.fragment
+    awk -F, '{ print $3 }' | awk '{ print "  cfg->devices["NR-1"] = &"$1";" }' >> decoder.fragment
 
 echo "}" >> decoder.fragment
 echo "" >> decoder.fragment